@@ -1,17 +1,30 @@
 #pragma once
 
+#include <atomic>
+#include <bit>
 #include <cassert>
-#include <cstdlib>
+#include <cstddef>
 #include <cstring>
-#include <functional>
-#include <iostream>
 #include <memory>
-#include <stdexcept>
+#include <new>
 #include <tuple>
 #include <type_traits>
+#include <utility>
+
+#ifdef POLICYCB_SBO_PROFILE
+#include "PolicyCB/SBOProfile.hpp"
+#endif
 
 namespace PolicyCB {
 
+// Accesses through a type with this attribute may alias any object. See
+// Callback for why.
+#if defined(__GNUC__)
+#define POLICYCB_MAY_ALIAS __attribute__((__may_alias__))
+#else
+#define POLICYCB_MAY_ALIAS
+#endif
+
 // The policy on allowed callable and Callback itself
 // Note that when none of them is DYNAMIC, Callback<> could
 // utilize flattened function pointer to save a virtual call
@@ -24,6 +37,13 @@ enum class MovePolicy
     TRIVIAL_ONLY = 1,
     // Forbids any move on Callback
     NOMOVE = 2,
+    // Only allows trivially relocatable object (see IsTriviallyRelocatable).
+    // Moving the Callback copies its bytes and never destroys the source
+    TRIVIAL_RELOCATION = 3,
+    // Allows non-trivially movable object, but moving the Callback never
+    // throws: callables whose move may throw are kept on the heap, even small
+    // ones. FIXED_SIZE Callbacks have no heap and reject them.
+    NOTHROW = 4,
 };
 
 enum class CopyPolicy
@@ -46,6 +66,129 @@ enum class DestroyPolicy
 
 // @}
 
+namespace internal {
+// What std::invoke does, without pulling in <functional>. Plain callables,
+// i.e. almost all of them, are called directly, which also keeps the
+// per-callable template instantiations down.
+// @{
+template<typename ClassT, typename ObjT>
+constexpr decltype(auto)
+memberTarget(ObjT&& obj) noexcept
+{
+    if constexpr (std::is_base_of_v<ClassT, std::remove_cvref_t<ObjT>>) {
+        return std::forward<ObjT>(obj);
+    } else if constexpr (requires { obj.get(); } && !requires { *obj; }) {
+        // std::reference_wrapper
+        return obj.get();
+    } else {
+        return *std::forward<ObjT>(obj);
+    }
+}
+
+template<typename MemberT, typename ClassT, typename ObjT, typename... CallArgs>
+constexpr decltype(auto)
+invokeMember(MemberT ClassT::*member, ObjT&& obj, CallArgs&&... args)
+{
+    if constexpr (std::is_function_v<MemberT>) {
+        return (memberTarget<ClassT>(std::forward<ObjT>(obj)).*member)(std::forward<CallArgs>(args)...);
+    } else {
+        return memberTarget<ClassT>(std::forward<ObjT>(obj)).*member;
+    }
+}
+
+template<typename F, typename... CallArgs>
+constexpr decltype(auto)
+invoke(F&& f, CallArgs&&... args)
+{
+    if constexpr (std::is_member_pointer_v<std::remove_cvref_t<F>>) {
+        return invokeMember(f, std::forward<CallArgs>(args)...);
+    } else {
+        return std::forward<F>(f)(std::forward<CallArgs>(args)...);
+    }
+}
+// @}
+} // namespace internal
+
+// Whether T can be moved to a new address by copying its bytes, after which
+// the source is treated as if it was never constructed. Specialize this for
+// your own types, or wrap a callable with assumeTriviallyRelocatable()
+template<typename T>
+struct IsTriviallyRelocatable : std::is_trivially_copyable<T>
+{
+};
+
+template<typename T>
+struct IsTriviallyRelocatable<std::unique_ptr<T, std::default_delete<T>>> : std::true_type
+{
+};
+
+template<typename T>
+struct IsTriviallyRelocatable<std::shared_ptr<T>> : std::true_type
+{
+};
+
+template<typename T>
+inline constexpr bool isTriviallyRelocatable = IsTriviallyRelocatable<T>::value;
+
+// A callable that is declared trivially relocatable by whoever wraps it,
+// e.g. a lambda that captures a std::unique_ptr
+template<typename ObjT>
+struct TriviallyRelocatableWrapper
+{
+    ObjT obj;
+
+    template<typename... CallArgs>
+    decltype(auto) operator()(CallArgs&&... args)
+    {
+        return internal::invoke(obj, std::forward<CallArgs>(args)...);
+    }
+};
+
+template<typename ObjT>
+struct IsTriviallyRelocatable<TriviallyRelocatableWrapper<ObjT>> : std::true_type
+{
+};
+
+template<typename ObjT>
+TriviallyRelocatableWrapper<ObjT>
+assumeTriviallyRelocatable(ObjT obj)
+{
+    return TriviallyRelocatableWrapper<ObjT>{ std::move(obj) };
+}
+
+// Calls the member function MemFn on obj. MemFn is a template argument, so
+// only obj is stored: a bound method fits an 8 byte FIXED_SIZE buffer, and
+// calls are direct instead of going through a runtime member pointer
+template<auto MemFn, typename ObjT>
+struct MemberBinding
+{
+    static_assert(std::is_member_function_pointer_v<decltype(MemFn)>);
+
+    ObjT* obj;
+
+    template<typename... CallArgs>
+    decltype(auto) operator()(CallArgs&&... args) const
+      noexcept(std::is_nothrow_invocable_v<decltype(MemFn), ObjT*, CallArgs...>)
+    {
+        return (obj->*MemFn)(std::forward<CallArgs>(args)...);
+    }
+};
+
+// e.g. FixedTrivialCB cb{ bindMember<&Handler::onRead>(handler) }
+template<auto MemFn, typename ObjT>
+MemberBinding<MemFn, ObjT>
+bindMember(ObjT& obj) noexcept requires(!std::is_pointer_v<ObjT>)
+{
+    return MemberBinding<MemFn, ObjT>{ std::addressof(obj) };
+}
+
+template<auto MemFn, typename ObjT>
+MemberBinding<MemFn, ObjT>
+bindMember(ObjT* obj) noexcept
+{
+    return MemberBinding<MemFn, ObjT>{ obj };
+}
+
 // Policy on the small-buffer-optimization storage
 enum class SBOPolicy
 {
@@ -59,6 +202,42 @@ enum class SBOPolicy
     // This disables storage of the original function,
     // essentially makes the Callback a function pointer
     NO_STORAGE = 2,
+    // Same as DYNAMIC_GROWTH, but heap-resident callables are reference
+    // counted and shared by copies of the Callback, which then only cost an
+    // atomic increment. Invoking through a non-const signature first gives
+    // the Callback its own copy of a shared callable. Requires an allocator
+    // whose instances always compare equal
+    SHARED_GROWTH = 3,
+    // Keeps a pointer to a callable owned by the caller, like
+    // std::function_ref, or a function pointer by value. Binding to a
+    // temporary is only safe until the end of the full expression.
+    // InitialBufferSize is ignored and MP/CP/DP must not be DYNAMIC
+    REFERENCE = 4,
+};
+
+// How a Callback reaches the stored callable
+enum class DynamicDispatchMethod
+{
+    NO_DISPATCH = 0,   // when SBOP is NO_STORAGE, equivalent to a function pointer
+    FUNC_PTR = 1,      // Only when both MP/CP/DP are all TRIVIAL_ONLY or NO
+    VIRTCALL = 2,      // when there're more than 1 dynamic method
+    STATIC_VTABLE = 3, // Same as VIRTCALL, but opted-in through DispatchPolicy::STATIC_VTABLE
+};
+
+// Policy on how the dynamic copy/move/destroy of VIRTCALL-eligible
+// Callbacks are dispatched
+enum class DispatchPolicy
+{
+    // Store a WrapperImpl with a vptr in the buffer. Smallest footprint,
+    // but invocations load the vptr, then the slot
+    AUTO = 0,
+    // Keep the invoke trampoline inline like FUNC_PTR and put copy/move/destroy
+    // in a static table per callable type. Takes 16 more bytes than AUTO with
+    // the same InitialBufferSize: one word for the trampoline pointer and one
+    // for the LifecycleTable pointer, both of which AUTO reaches through the
+    // vptr. In exchange the buffer holds the bare callable, without the 8-byte
+    // vptr, and calls are a single indirect jump
+    STATIC_VTABLE = 1,
 };
 
 namespace internal {
@@ -66,42 +245,105 @@ struct Empty
 {
 };
 
+// How an argument travels through trampolines and WrapperBase::invoke().
+// Small trivially copyable values are passed by value, so that they stay in
+// registers. Everything else is passed by reference, so that by-value
+// parameters are only moved once, into the callable.
+template<typename T>
+using PassType = std::conditional_t<!std::is_reference_v<T> && std::is_trivially_copyable_v<T> &&
+                                      sizeof(T) <= 2 * sizeof(void*),
+                                    T,
+                                    T&&>;
+
+// How CallbackBatch, CallbackList, Signal, TaskQueue and TimerWheel pass the
+// arguments of one call on to each of the many callbacks they invoke, whose
+// return values they discard. By-value and rvalue reference arguments are
+// copied, so that every callback gets an object of its own that it may move
+// from; lvalue references are passed as they are. Move-only by-value and
+// rvalue reference arguments cannot be fanned out.
+// @{
+template<typename Arg>
+using FanOutType = std::conditional_t<std::is_lvalue_reference_v<Arg>, Arg, std::remove_cvref_t<Arg>>;
+
+template<typename Arg>
+constexpr FanOutType<Arg>
+fanOut(std::remove_reference_t<Arg>& arg)
+{
+    static_assert(std::is_lvalue_reference_v<Arg> || std::is_copy_constructible_v<FanOutType<Arg>>,
+                  "Every callback needs its own copy of by-value and rvalue reference arguments");
+    return arg;
+}
+// @}
+
+// Decomposes a signature such as int(int), int(int) noexcept,
+// int(int) const or int(int) const noexcept
 template<typename T>
 struct CallableTypeHelper;
-template<typename Ret, typename... Args>
-struct CallableTypeHelper<Ret(Args...)>
+template<typename Ret, bool isNoexcept_, typename... Args>
+struct CallableTypeHelper<Ret(Args...) noexcept(isNoexcept_)>
 {
     using ReturnType = Ret;
     using ArgsTuple = std::tuple<Args...>;
-    using TrampolineType = Ret(Args&&..., void*);
+    // The signature without const, which is what function pointers and
+    // invoke() of WrapperBase get
+    using InvokeType = Ret(Args...) noexcept(isNoexcept_);
+    using TrampolineType = Ret(PassType<Args>..., void*) noexcept(isNoexcept_);
     using TrampolinePtrType = TrampolineType*;
+    static constexpr bool isNoexcept = isNoexcept_;
+    static constexpr bool isConst = false;
+    template<typename ObjT>
+    using satisfiedBy = std::conditional_t<isNoexcept,
+                                           std::is_nothrow_invocable_r<Ret, ObjT, Args&&...>,
+                                           std::is_invocable_r<Ret, ObjT, Args&&...>>;
+};
+template<typename Ret, bool isNoexcept_, typename... Args>
+struct CallableTypeHelper<Ret(Args...) const noexcept(isNoexcept_)>
+  : CallableTypeHelper<Ret(Args...) noexcept(isNoexcept_)>
+{
+    using NonConstHelper = CallableTypeHelper<Ret(Args...) noexcept(isNoexcept_)>;
+    static constexpr bool isConst = true;
+    // The callable is invoked as const
     template<typename ObjT>
-    using satisfiedBy = std::is_invocable_r<Ret, ObjT, Args&&...>;
+    using satisfiedBy = typename NonConstHelper::template satisfiedBy<const std::remove_reference_t<ObjT>&>;
 };
 
 template<typename FT, MovePolicy movePolicy, CopyPolicy copyPolicy, DestroyPolicy destroyPolicy>
 struct WrapperBase;
 
-template<typename RetT, MovePolicy movePolicy, CopyPolicy copyPolicy, DestroyPolicy destroyPolicy, typename... Args>
-struct WrapperBase<RetT(Args...), movePolicy, copyPolicy, destroyPolicy>
+template<typename RetT,
+         MovePolicy movePolicy,
+         CopyPolicy copyPolicy,
+         DestroyPolicy destroyPolicy,
+         bool isNoexcept,
+         typename... Args>
+struct WrapperBase<RetT(Args...) noexcept(isNoexcept), movePolicy, copyPolicy, destroyPolicy>
 {
     virtual ~WrapperBase() {}
     virtual void copyTo(void* dest) const = 0;
     virtual void moveTo(void* other) && = 0;
-    virtual RetT invoke(Args&&... args) = 0;
+    virtual RetT invoke(PassType<Args>... args) noexcept(isNoexcept) = 0;
 };
 
-template<typename FT, typename ObjT, MovePolicy movePolicy, CopyPolicy copyPolicy, DestroyPolicy destroyPolicy>
+// FT is the InvokeType of the signature. constInvoke is set for const
+// signatures and makes invoke() call the callable as const.
+template<typename FT,
+         typename ObjT,
+         bool constInvoke,
+         MovePolicy movePolicy,
+         CopyPolicy copyPolicy,
+         DestroyPolicy destroyPolicy>
 struct WrapperImpl;
 
 template<typename RetT,
          typename ObjT,
+         bool constInvoke,
          MovePolicy movePolicy,
          CopyPolicy copyPolicy,
          DestroyPolicy destroyPolicy,
+         bool isNoexcept,
          typename... Args>
-struct WrapperImpl<RetT(Args...), ObjT, movePolicy, copyPolicy, destroyPolicy>
-  : public WrapperBase<RetT(Args...), movePolicy, copyPolicy, destroyPolicy>
+struct WrapperImpl<RetT(Args...) noexcept(isNoexcept), ObjT, constInvoke, movePolicy, copyPolicy, destroyPolicy>
+  : public WrapperBase<RetT(Args...) noexcept(isNoexcept), movePolicy, copyPolicy, destroyPolicy>
 {
     ~WrapperImpl() {}
     [[no_unique_address]] ObjT obj;
@@ -109,59 +351,264 @@ struct WrapperImpl<RetT(Args...), ObjT, movePolicy, copyPolicy, destroyPolicy>
       : obj(std::move(obj))
     {
     }
+    // Not implicitly declared because of the destructor above; without the
+    // move constructor moveTo() would copy, which move-only ObjT cannot do
+    WrapperImpl(const WrapperImpl&) = default;
+    WrapperImpl(WrapperImpl&&) = default;
     void copyTo(void* other) const
     {
-        if constexpr (copyPolicy == CopyPolicy::DYNAMIC) {
+        if constexpr (copyPolicy != CopyPolicy::NOCOPY) {
             new (static_cast<WrapperImpl*>(other)) WrapperImpl(*this);
         }
     }
     void moveTo(void* other) &&
     {
-        if constexpr (movePolicy == MovePolicy::DYNAMIC) {
+        // TRIVIAL_RELOCATION moves are done by Callback with memcpy
+        if constexpr (movePolicy == MovePolicy::DYNAMIC || movePolicy == MovePolicy::NOTHROW ||
+                      movePolicy == MovePolicy::TRIVIAL_ONLY) {
             new (static_cast<WrapperImpl*>(other)) WrapperImpl(std::move(*this));
         }
     }
 
-    RetT invoke(Args&&... args) final
+    RetT invoke(PassType<Args>... args) noexcept(isNoexcept) final
+    {
+        if constexpr (constInvoke) {
+            return internal::invoke(std::as_const(obj), std::forward<Args>(args)...);
+        } else {
+            return internal::invoke(obj, std::forward<Args>(args)...);
+        }
+    }
+};
+
+// Per-callable copy/move/destroy used by DynamicDispatchMethod::STATIC_VTABLE.
+// Entries forbidden by the policies are nullptr. A null moveTo on a movable
+// Callback means the callable is relocated by memcpy.
+struct LifecycleTable
+{
+    void (*copyTo)(const void* src, void* dest);
+    void (*moveTo)(void* src, void* dest);
+    void (*destroy)(void* obj) noexcept;
+};
+
+template<typename ObjT>
+struct LifecycleImpl
+{
+    static void copyTo(const void* src, void* dest)
+    {
+        new (dest) ObjT(*static_cast<const ObjT*>(src));
+    }
+    static void moveTo(void* src, void* dest)
+    {
+        new (dest) ObjT(std::move(*static_cast<ObjT*>(src)));
+    }
+    static void destroy(void* obj) noexcept
+    {
+        static_cast<ObjT*>(obj)->~ObjT();
+    }
+};
+
+template<typename ObjT, MovePolicy movePolicy, CopyPolicy copyPolicy>
+constexpr LifecycleTable
+makeLifecycleTable() noexcept
+{
+    // Only instantiate what the policies allow, so that e.g. move-only
+    // callables work with CopyPolicy::NOCOPY
+    LifecycleTable table{ nullptr, nullptr, &LifecycleImpl<ObjT>::destroy };
+    if constexpr (copyPolicy != CopyPolicy::NOCOPY) {
+        table.copyTo = &LifecycleImpl<ObjT>::copyTo;
+    }
+    if constexpr (movePolicy != MovePolicy::NOMOVE && !isTriviallyRelocatable<ObjT>) {
+        table.moveTo = &LifecycleImpl<ObjT>::moveTo;
+    }
+    return table;
+}
+
+template<typename ObjT, MovePolicy movePolicy, CopyPolicy copyPolicy>
+inline constexpr LifecycleTable lifecycleTable = makeLifecycleTable<ObjT, movePolicy, copyPolicy>();
+
+// What a REFERENCE Callback stores for a callable that is not a function
+// pointer. Const signatures only get to see the callable as const.
+template<typename ObjT>
+struct ObjectRef
+{
+    ObjT* obj;
+
+    template<typename... CallArgs>
+    decltype(auto) operator()(CallArgs&&... args) const noexcept(std::is_nothrow_invocable_v<ObjT&, CallArgs...>)
+    {
+        return internal::invoke(*obj, std::forward<CallArgs>(args)...);
+    }
+};
+
+template<typename T>
+inline constexpr bool isObjectRef = false;
+
+template<typename ObjT>
+inline constexpr bool isObjectRef<ObjectRef<ObjT>> = true;
+
+// Stands for the callable of a FIXED_SIZE FUNC_PTR Callback converted to a
+// STATIC_VTABLE one, whose type is no longer known
+template<std::size_t Size>
+struct TrivialPayload
+{
+    alignas(std::size_t) unsigned char bytes[Size];
+};
+
+// Stands for the callable of a FIXED_SIZE FUNC_PTR Callback converted to a
+// VIRTCALL one: the trampoline it was called through and the bytes it is
+// called on
+template<typename TrampolinePtrType, std::size_t Size>
+struct TrampolinePayload
+{
+    TrampolinePtrType trampoline;
+    TrivialPayload<Size> payload;
+};
+
+// Invoking jumps straight to the trampoline, without calling through the
+// Callback it came from first
+template<typename RetT,
+         typename TrampolinePtrType,
+         std::size_t Size,
+         bool constInvoke,
+         MovePolicy movePolicy,
+         CopyPolicy copyPolicy,
+         DestroyPolicy destroyPolicy,
+         bool isNoexcept,
+         typename... Args>
+struct WrapperImpl<RetT(Args...) noexcept(isNoexcept),
+                   TrampolinePayload<TrampolinePtrType, Size>,
+                   constInvoke,
+                   movePolicy,
+                   copyPolicy,
+                   destroyPolicy>
+  : public WrapperBase<RetT(Args...) noexcept(isNoexcept), movePolicy, copyPolicy, destroyPolicy>
+{
+    TrampolinePayload<TrampolinePtrType, Size> obj;
+    explicit WrapperImpl(const TrampolinePayload<TrampolinePtrType, Size>& obj) noexcept
+      : obj(obj)
+    {
+    }
+    void copyTo(void* other) const
+    {
+        if constexpr (copyPolicy != CopyPolicy::NOCOPY) {
+            new (static_cast<WrapperImpl*>(other)) WrapperImpl(*this);
+        }
+    }
+    void moveTo(void* other) &&
+    {
+        if constexpr (movePolicy == MovePolicy::DYNAMIC || movePolicy == MovePolicy::NOTHROW ||
+                      movePolicy == MovePolicy::TRIVIAL_ONLY) {
+            new (static_cast<WrapperImpl*>(other)) WrapperImpl(*this);
+        }
+    }
+
+    RetT invoke(PassType<Args>... args) noexcept(isNoexcept) final
     {
-        return std::invoke(obj, std::forward<Args>(args)...);
+        return obj.trampoline(std::forward<PassType<Args>>(args)..., obj.payload.bytes);
     }
 };
 
-template<SBOPolicy sboPolicy, std::size_t InitialBufferSize>
+// The object representation of a callable, as std::bit_cast produces it
+template<std::size_t Size>
+struct ByteArray
+{
+    unsigned char bytes[Size];
+};
+
+template<typename Allocator>
+struct HeapStorage
+{
+    unsigned char* buffer = nullptr;
+    [[no_unique_address]] Allocator allocator;
+};
+
+template<SBOPolicy sboPolicy, std::size_t InitialBufferSize, typename Allocator>
 class SBOImpl
 {
   public:
     static_assert(sboPolicy == SBOPolicy::NO_STORAGE || InitialBufferSize >= sizeof(std::size_t));
+    // Heap buffers are allocated in units of max_align_t so that spilled objects
+    // are suitably aligned regardless of the value_type of the user's allocator
+    using BlockAllocatorT = typename std::allocator_traits<Allocator>::template rebind_alloc<std::max_align_t>;
+    using BlockAllocTraits = std::allocator_traits<BlockAllocatorT>;
+    static_assert(std::is_same_v<typename BlockAllocTraits::pointer, std::max_align_t*>,
+                  "Fancy pointers are not supported");
     using HeapStorageT = std::conditional_t<sboPolicy == SBOPolicy::NO_STORAGE || sboPolicy == SBOPolicy::FIXED_SIZE,
                                             Empty,
-                                            std::unique_ptr<unsigned char[]>>;
+                                            HeapStorage<Allocator>>;
 
     union PolyStackStorage {
         std::size_t heapBufferSize = 0;
         unsigned char stackBuffer[InitialBufferSize];
+        // What storeConstant() writes for an ObjectRef
+        const void* pointer;
     };
     using StackStorageT = std::conditional_t<sboPolicy == SBOPolicy::NO_STORAGE, Empty, PolyStackStorage>;
 
   private:
+    static constexpr bool hasHeap = sboPolicy != SBOPolicy::NO_STORAGE && sboPolicy != SBOPolicy::FIXED_SIZE;
+    static constexpr bool sharedHeap = sboPolicy == SBOPolicy::SHARED_GROWTH;
+    static_assert(!sharedHeap || std::allocator_traits<Allocator>::is_always_equal::value,
+                  "SHARED_GROWTH needs an allocator whose instances always compare equal");
+    // Shared heap buffers start with a block holding the reference count
+    static constexpr std::size_t headerBlocks = sharedHeap ? 1 : 0;
+
     [[no_unique_address]] StackStorageT stackStorage;
     [[no_unique_address]] HeapStorageT heapStorage;
 
+    static HeapStorageT makeHeapStorage(const Allocator& allocator) noexcept
+    {
+        if constexpr (hasHeap) {
+            return HeapStorageT{ nullptr, allocator };
+        } else {
+            return HeapStorageT{};
+        }
+    }
+
+    static constexpr std::size_t blockCount(std::size_t size) noexcept
+    {
+        return (size + sizeof(std::max_align_t) - 1) / sizeof(std::max_align_t);
+    }
+
+    std::atomic<std::size_t>& refCount() const noexcept
+    {
+        auto* header = reinterpret_cast<std::max_align_t*>(heapStorage.buffer) - headerBlocks;
+        return *std::launder(reinterpret_cast<std::atomic<std::size_t>*>(header));
+    }
+
     void switchToHeap(std::size_t newSize)
     {
-        if constexpr (sboPolicy != SBOPolicy::NO_STORAGE && sboPolicy != SBOPolicy::FIXED_SIZE) {
-            assert(!heapStorage);
-            heapStorage = std::make_unique<unsigned char[]>(newSize);
+        if constexpr (hasHeap) {
+            assert(!heapStorage.buffer);
+            BlockAllocatorT blockAllocator(heapStorage.allocator);
+            std::max_align_t* blocks = BlockAllocTraits::allocate(blockAllocator, headerBlocks + blockCount(newSize));
+            heapStorage.buffer = reinterpret_cast<unsigned char*>(blocks + headerBlocks);
             stackStorage.heapBufferSize = newSize;
+            if constexpr (sharedHeap) {
+                new (blocks) std::atomic<std::size_t>(1);
+            }
         }
     }
 
-    void switchToStack()
+    void switchToStack() noexcept
     {
-        if constexpr (sboPolicy != SBOPolicy::NO_STORAGE && sboPolicy != SBOPolicy::FIXED_SIZE) {
-            assert(heapStorage);
+        if constexpr (hasHeap) {
+            assert(heapStorage.buffer);
+            BlockAllocatorT blockAllocator(heapStorage.allocator);
+            BlockAllocTraits::deallocate(blockAllocator,
+                                         reinterpret_cast<std::max_align_t*>(heapStorage.buffer) - headerBlocks,
+                                         headerBlocks + blockCount(stackStorage.heapBufferSize));
+            heapStorage.buffer = nullptr;
             stackStorage.heapBufferSize = 0;
-            heapStorage.reset();
+        }
+    }
+
+    void shareHeapOf(const SBOImpl& other) noexcept
+    {
+        if constexpr (sharedHeap) {
+            other.refCount().fetch_add(1, std::memory_order_relaxed);
+            heapStorage.buffer = other.heapStorage.buffer;
+            stackStorage.heapBufferSize = other.stackStorage.heapBufferSize;
         }
     }
 
@@ -173,10 +620,10 @@ class SBOImpl
         } else if constexpr (sboPolicy == SBOPolicy::FIXED_SIZE) {
             return stackStorage.stackBuffer;
         } else {
-            if (!heapStorage) {
+            if (!heapStorage.buffer) {
                 return stackStorage.stackBuffer;
             } else {
-                return heapStorage.get();
+                return heapStorage.buffer;
             }
         }
     }
@@ -188,60 +635,254 @@ class SBOImpl
         } else if constexpr (sboPolicy == SBOPolicy::FIXED_SIZE) {
             return stackStorage.stackBuffer;
         } else {
-            if (!heapStorage) {
+            if (!heapStorage.buffer) {
                 return stackStorage.stackBuffer;
             } else {
-                return heapStorage.get();
+                return heapStorage.buffer;
             }
         }
     }
+
+    // Stands in for placement new in constant evaluation, where a callable
+    // cannot be created in the byte buffer. Its bytes are written instead,
+    // and the rest of the buffer is zeroed so that the storage is fully
+    // initialized. Callables with padding or with pointers other than an
+    // ObjectRef are not constant-evaluable.
+    template<typename ObjT>
+    constexpr void storeConstant(const ObjT& obj) noexcept
+    {
+        static_assert(sboPolicy == SBOPolicy::FIXED_SIZE && sizeof(ObjT) <= InitialBufferSize);
+        if constexpr (isObjectRef<ObjT>) {
+            stackStorage.pointer = obj.obj;
+        } else if constexpr (std::is_empty_v<ObjT>) {
+            for (std::size_t i = 0; i < InitialBufferSize; ++i) {
+                stackStorage.stackBuffer[i] = 0;
+            }
+        } else {
+            const auto objBytes = std::bit_cast<ByteArray<sizeof(ObjT)>>(obj);
+            for (std::size_t i = 0; i < InitialBufferSize; ++i) {
+                stackStorage.stackBuffer[i] = i < sizeof(ObjT) ? objBytes.bytes[i] : 0;
+            }
+        }
+    }
+
     SBOImpl() = default;
-    SBOImpl(SBOImpl&) = delete;
-    SBOImpl(SBOImpl&&) = default;
-    SBOImpl& operator=(SBOImpl&&) = default;
-    SBOImpl& operator=(SBOImpl&) = delete;
+    explicit SBOImpl(const Allocator& allocator) noexcept
+      : heapStorage(makeHeapStorage(allocator))
+    {
+    }
+    SBOImpl(SBOImpl&) requires(hasHeap) = delete;
+    SBOImpl& operator=(SBOImpl&) requires(hasHeap) = delete;
+
+    // Without a heap buffer, the storage is plain bytes
+    SBOImpl(const SBOImpl&) requires(!hasHeap) = default;
+    SBOImpl& operator=(const SBOImpl&) requires(!hasHeap) = default;
+    SBOImpl(SBOImpl&&) noexcept requires(!hasHeap) = default;
+    SBOImpl& operator=(SBOImpl&&) noexcept requires(!hasHeap) = default;
+
+    // Steals the heap buffer (if any) together with the allocator that owns it
+    SBOImpl(SBOImpl&& other) noexcept requires(hasHeap)
+      : stackStorage(other.stackStorage)
+      , heapStorage(other.heapStorage)
+    {
+        other.heapStorage.buffer = nullptr;
+        other.stackStorage.heapBufferSize = 0;
+    }
+
+    // Only valid when canAdoptHeapOf(other) holds
+    SBOImpl& operator=(SBOImpl&& other) noexcept requires(hasHeap)
+    {
+        if (this == &other) {
+            return *this;
+        }
+        assert(canAdoptHeapOf(other));
+        if (heapStorage.buffer) {
+            switchToStack();
+        }
+        if constexpr (std::allocator_traits<Allocator>::propagate_on_container_move_assignment::value) {
+            heapStorage.allocator = other.heapStorage.allocator;
+        }
+        heapStorage.buffer = other.heapStorage.buffer;
+        stackStorage = other.stackStorage;
+        other.heapStorage.buffer = nullptr;
+        other.stackStorage.heapBufferSize = 0;
+        return *this;
+    }
+
+    ~SBOImpl() requires(!hasHeap) = default;
+    ~SBOImpl() requires(hasHeap)
+    {
+        if (heapStorage.buffer) {
+            switchToStack();
+        }
+    }
+
+    // Storage for a copy-constructed Callback: same layout, allocator chosen by
+    // select_on_container_copy_construction
     SBOImpl cloneStorage() const
     {
-        SBOImpl result;
-        if constexpr (sboPolicy == SBOPolicy::NO_STORAGE || sboPolicy == SBOPolicy::FIXED_SIZE) {
+        if constexpr (!hasHeap) {
+            SBOImpl result;
             result.stackStorage = stackStorage;
+            return result;
         } else {
-            if (heapStorage) {
-                result.heapStorage = std::make_unique<unsigned char[]>(effectiveBufferSize());
-                result.stackStorage.heapBufferSize = stackStorage.heapBufferSize;
+            SBOImpl result(
+              std::allocator_traits<Allocator>::select_on_container_copy_construction(heapStorage.allocator));
+            if (heapStorage.buffer) {
+                if constexpr (sharedHeap) {
+                    result.shareHeapOf(*this);
+                } else {
+                    result.switchToHeap(effectiveBufferSize());
+                }
             }
+            return result;
         }
+    }
+
+    // A fresh, unshared heap buffer of the same size, for unsharing
+    SBOImpl cloneHeap() const
+    {
+        SBOImpl result(heapStorage.allocator);
+        result.switchToHeap(effectiveBufferSize());
         return result;
     }
 
+    // Prepares the storage of a copy-assigned Callback, reusing the current
+    // heap buffer when it already has the right size
+    void cloneStorageFrom(const SBOImpl& other)
+    {
+        if constexpr (!hasHeap) {
+            stackStorage = other.stackStorage;
+        } else {
+            if constexpr (std::allocator_traits<Allocator>::propagate_on_container_copy_assignment::value) {
+                if (heapStorage.buffer && !(heapStorage.allocator == other.heapStorage.allocator)) {
+                    switchToStack();
+                }
+                heapStorage.allocator = other.heapStorage.allocator;
+            }
+            if constexpr (sharedHeap) {
+                if (other.heapStorage.buffer) {
+                    if (heapStorage.buffer) {
+                        switchToStack();
+                    }
+                    shareHeapOf(other);
+                    return;
+                }
+            }
+            // A heap buffer may be smaller than the stack buffer, see
+            // MovePolicy::NOTHROW
+            if (other.heapStorage.buffer) {
+                resizeToHeap(other.effectiveBufferSize());
+            } else {
+                resizeTo(other.effectiveBufferSize());
+            }
+        }
+    }
+
+    // Whether the heap buffer is shared with other Callbacks
+    bool heapShared() const noexcept
+    {
+        if constexpr (sharedHeap) {
+            return heapStorage.buffer && refCount().load(std::memory_order_acquire) != 1;
+        } else {
+            return false;
+        }
+    }
+
+    bool sharesHeapWith(const SBOImpl& other) const noexcept
+    {
+        if constexpr (sharedHeap) {
+            return heapStorage.buffer && heapStorage.buffer == other.heapStorage.buffer;
+        } else {
+            return false;
+        }
+    }
+
+    // Drops this reference to a shared heap buffer. Returns true when it was
+    // the last one: the caller then has to destroy the callable, and the
+    // buffer stays as an unshared one. Otherwise the storage is left empty.
+    bool releaseSharedHeap() noexcept
+    {
+        if constexpr (sharedHeap) {
+            assert(heapStorage.buffer);
+            if (refCount().fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                refCount().store(1, std::memory_order_relaxed);
+                return true;
+            }
+            heapStorage.buffer = nullptr;
+            stackStorage.heapBufferSize = 0;
+            return false;
+        } else {
+            return true;
+        }
+    }
+
+    // Whether the heap buffer of other could be taken over by move assignment
+    bool canAdoptHeapOf(const SBOImpl& other) const noexcept
+    {
+        if constexpr (!hasHeap || std::allocator_traits<Allocator>::propagate_on_container_move_assignment::value ||
+                      std::allocator_traits<Allocator>::is_always_equal::value) {
+            return true;
+        } else {
+            return heapStorage.allocator == other.heapStorage.allocator;
+        }
+    }
+
     void resizeTo(std::size_t newSize)
     {
-        if constexpr (sboPolicy == SBOPolicy::NO_STORAGE || sboPolicy == SBOPolicy::FIXED_SIZE) {
+        if constexpr (!hasHeap) {
             return;
         } else {
             if (newSize <= InitialBufferSize) {
-                heapStorage.reset();
-            } else if (!heapStorage || stackStorage.heapBufferSize != newSize) {
-                stackStorage.heapBufferSize = newSize;
-                heapStorage = std::make_unique<unsigned char[]>(newSize);
+                if (heapStorage.buffer) {
+                    switchToStack();
+                }
+            } else if (!heapStorage.buffer || stackStorage.heapBufferSize != newSize) {
+                if (heapStorage.buffer) {
+                    switchToStack();
+                }
+                switchToHeap(newSize);
             }
         }
     }
+
+    // Like resizeTo(), but puts the buffer on the heap however small it is
+    void resizeToHeap(std::size_t newSize)
+    {
+        if constexpr (hasHeap) {
+            if (!heapStorage.buffer || stackStorage.heapBufferSize != newSize) {
+                if (heapStorage.buffer) {
+                    switchToStack();
+                }
+                switchToHeap(newSize);
+            }
+        }
+    }
+
     bool onHeap() const noexcept
     {
-        if constexpr (sboPolicy == SBOPolicy::NO_STORAGE || sboPolicy == SBOPolicy::FIXED_SIZE) {
+        if constexpr (!hasHeap) {
             return false;
         } else {
-            return heapStorage != nullptr;
+            return heapStorage.buffer != nullptr;
         }
     }
 
     size_t effectiveBufferSize() const noexcept
     {
-        if constexpr (sboPolicy == SBOPolicy::NO_STORAGE || sboPolicy == SBOPolicy::FIXED_SIZE) {
+        if constexpr (!hasHeap) {
             return InitialBufferSize;
         } else {
-            return heapStorage ? stackStorage.heapBufferSize : InitialBufferSize;
+            return heapStorage.buffer ? stackStorage.heapBufferSize : InitialBufferSize;
+        }
+    }
+
+    Allocator getAllocator() const noexcept
+    {
+        if constexpr (hasHeap) {
+            return heapStorage.allocator;
+        } else {
+            return Allocator();
         }
     }
 };
@@ -249,16 +890,23 @@ class SBOImpl
 template<typename FT, typename ObjT>
 struct TrampolineImpl;
 
-template<typename RetT, typename ObjT, typename... Args>
-struct TrampolineImpl<RetT(Args...), ObjT>
+template<typename RetT, typename ObjT, bool isNoexcept, typename... Args>
+struct TrampolineImpl<RetT(Args...) noexcept(isNoexcept), ObjT>
 {
-    static_assert(std::is_invocable_r_v<RetT, ObjT, Args...>);
-    static RetT call(Args&&... args, void* obj)
+    static RetT call(PassType<Args>... args, void* obj) noexcept(isNoexcept)
     {
-        return std::invoke(*static_cast<ObjT*>(obj), std::forward<Args>(args)...);
+        return internal::invoke(*static_cast<ObjT*>(obj), std::forward<Args>(args)...);
+    }
+};
+
+// Const signatures only ever see the callable as const
+template<typename RetT, typename ObjT, bool isNoexcept, typename... Args>
+struct TrampolineImpl<RetT(Args...) const noexcept(isNoexcept), ObjT>
+{
+    static RetT call(PassType<Args>... args, void* obj) noexcept(isNoexcept)
+    {
+        return internal::invoke(*static_cast<const ObjT*>(obj), std::forward<Args>(args)...);
     }
-    static_assert(
-      std::is_same_v<decltype(&TrampolineImpl::call), typename CallableTypeHelper<RetT(Args&&...)>::TrampolinePtrType>);
 };
 
 template<typename FT, typename ObjT>
@@ -300,6 +948,113 @@ struct FuncPtrBase<Empty>
 {
 };
 
+template<typename LifecycleTablePtrType>
+struct LifecycleTableBase
+{
+    [[no_unique_address]] LifecycleTablePtrType lifecycleTable;
+};
+
+template<>
+struct LifecycleTableBase<Empty>
+{
+};
+
+// Lets containers built on Callback (CallbackBatch, ...) take a Callback apart
+struct CallbackAccess
+{
+    template<typename CallbackT>
+    static auto& trampolinePtr(CallbackT& cb) noexcept
+    {
+        return cb.trampolinePtr;
+    }
+
+    template<typename CallbackT>
+    static auto* storage(CallbackT& cb) noexcept
+    {
+        return cb.storage.getStorage();
+    }
+};
+
+template<typename Traits>
+struct CallbackMembers
+  : StorageBase<typename Traits::StorageT>
+  , TrampolineBase<typename Traits::TrampolinePtrType>
+  , FuncPtrBase<typename Traits::FuncPtrType>
+  , LifecycleTableBase<typename Traits::LifecycleTablePtrType>
+{
+    CallbackMembers() = default;
+
+    // The other members are value-initialized
+    constexpr explicit CallbackMembers(typename Traits::StorageT storage)
+      : StorageBase<typename Traits::StorageT>{ std::move(storage) }
+      , TrampolineBase<typename Traits::TrampolinePtrType>{}
+      , FuncPtrBase<typename Traits::FuncPtrType>{}
+      , LifecycleTableBase<typename Traits::LifecycleTablePtrType>{}
+    {
+    }
+};
+
+// Brackets a call with InvokeProbe::enter() and InvokeProbe::exit()
+template<typename InvokeProbe>
+struct ProbeScope
+{
+    const void* key;
+    decltype(InvokeProbe::enter(nullptr)) token;
+
+    template<typename CallbackT>
+    explicit ProbeScope(const CallbackT& cb) noexcept
+      : key(cb.probeKey())
+      , token(InvokeProbe::enter(key))
+    {
+    }
+
+    ProbeScope(const ProbeScope&) = delete;
+    ProbeScope& operator=(const ProbeScope&) = delete;
+
+    ~ProbeScope()
+    {
+        InvokeProbe::exit(key, token);
+    }
+};
+
+// Provides Callback::operator() with the qualifiers of the signature. The
+// probe is compiled in only when InvokeProbe is not void, so that unprobed
+// Callbacks generate the same code as without it.
+template<typename CallbackT, typename FT, typename InvokeProbe = void>
+struct CallOperatorBase;
+
+template<typename CallbackT, typename InvokeProbe, typename RetT, bool isNoexcept, typename... Args>
+struct CallOperatorBase<CallbackT, RetT(Args...) noexcept(isNoexcept), InvokeProbe>
+{
+    constexpr RetT operator()(Args... args) noexcept(isNoexcept)
+    {
+        if constexpr (std::is_void_v<InvokeProbe>) {
+            return static_cast<CallbackT&>(*this).invokeStored(std::forward<Args>(args)...);
+        } else {
+            ProbeScope<InvokeProbe> probeScope(static_cast<const CallbackT&>(*this));
+            return static_cast<CallbackT&>(*this).invokeStored(std::forward<Args>(args)...);
+        }
+    }
+};
+
+template<typename CallbackT, typename InvokeProbe, typename RetT, bool isNoexcept, typename... Args>
+struct CallOperatorBase<CallbackT, RetT(Args...) const noexcept(isNoexcept), InvokeProbe>
+{
+    constexpr RetT operator()(Args... args) const noexcept(isNoexcept)
+    {
+        // The trampoline and WrapperImpl of const signatures only access
+        // the callable as const
+        if constexpr (std::is_void_v<InvokeProbe>) {
+            return const_cast<CallbackT&>(static_cast<const CallbackT&>(*this))
+              .invokeStored(std::forward<Args>(args)...);
+        } else {
+            ProbeScope<InvokeProbe> probeScope(static_cast<const CallbackT&>(*this));
+            return const_cast<CallbackT&>(static_cast<const CallbackT&>(*this))
+              .invokeStored(std::forward<Args>(args)...);
+        }
+    }
+};
+
 template<typename FT,
          MovePolicy MP,
          CopyPolicy CP,
@@ -307,86 +1062,214 @@ template<typename FT,
          SBOPolicy SBOP,
          // Setting this to zero disables SBO
          // by allocating everything on heap
-         std::size_t InitialBufferSize = 16>
+         std::size_t InitialBufferSize = 16,
+         typename Allocator = std::allocator<unsigned char>,
+         DispatchPolicy DispP = DispatchPolicy::AUTO>
 struct CallbackTraits
 {
-    using StorageT = internal::SBOImpl<SBOP, InitialBufferSize>;
-    enum class DynamicDispatchMethod
-    {
-        NO_DISPATCH = 0, // when SBOP is NO_STORAGE, equivalent to a function pointer
-        FUNC_PTR = 1,    // Only when both MP/CP/DP are all TRIVIAL_ONLY or NO
-        VIRTCALL = 2,    // when there're more than 1 dynamic method
-    };
+    // REFERENCE Callbacks hold an ObjectRef or a function pointer
+    using StorageT = std::conditional_t<SBOP == SBOPolicy::REFERENCE,
+                                        internal::SBOImpl<SBOPolicy::FIXED_SIZE, sizeof(void*), Allocator>,
+                                        internal::SBOImpl<SBOP, InitialBufferSize, Allocator>>;
+    using DynamicDispatchMethod = PolicyCB::DynamicDispatchMethod;
 
     static constexpr DynamicDispatchMethod dynamicDispatchMethod =
       SBOP == SBOPolicy::NO_STORAGE
         ? DynamicDispatchMethod::NO_DISPATCH
-        : ((MP != MovePolicy::DYNAMIC) && (CP != CopyPolicy::DYNAMIC) && (DP != DestroyPolicy::DYNAMIC)
+        : ((MP != MovePolicy::DYNAMIC && MP != MovePolicy::NOTHROW) && (CP != CopyPolicy::DYNAMIC) &&
+               (DP != DestroyPolicy::DYNAMIC)
              ? DynamicDispatchMethod::FUNC_PTR
-             : DynamicDispatchMethod::VIRTCALL);
+             : (DispP == DispatchPolicy::STATIC_VTABLE ? DynamicDispatchMethod::STATIC_VTABLE
+                                                       : DynamicDispatchMethod::VIRTCALL));
 
     using type = typename internal::CallableTypeHelper<FT>::ReturnType;
     using ReturnType = typename internal::CallableTypeHelper<FT>::ReturnType;
     using ArgsTuple = typename internal::CallableTypeHelper<FT>::ArgsTuple;
+    using InvokeType = typename internal::CallableTypeHelper<FT>::InvokeType;
     using FuncPtrType =
-      std::conditional_t<dynamicDispatchMethod == DynamicDispatchMethod::NO_DISPATCH, FT*, internal::Empty>;
+      std::conditional_t<dynamicDispatchMethod == DynamicDispatchMethod::NO_DISPATCH, InvokeType*, internal::Empty>;
 
     template<typename ObjT>
-    using StoredObjT = std::conditional_t<dynamicDispatchMethod == DynamicDispatchMethod::FUNC_PTR,
+    using WrapperImplT = internal::WrapperImpl<InvokeType, ObjT, internal::CallableTypeHelper<FT>::isConst, MP, CP, DP>;
+
+    template<typename ObjT>
+    using StoredObjT = std::conditional_t<dynamicDispatchMethod == DynamicDispatchMethod::FUNC_PTR ||
+                                            dynamicDispatchMethod == DynamicDispatchMethod::STATIC_VTABLE,
                                           ObjT,
                                           std::conditional_t<dynamicDispatchMethod == DynamicDispatchMethod::VIRTCALL,
-                                                             internal::WrapperImpl<FT, ObjT, MP, CP, DP>,
+                                                             WrapperImplT<ObjT>,
                                                              internal::Empty>>;
 
-    using WrapperBaseType = internal::WrapperBase<FT, MP, CP, DP>;
+    using WrapperBaseType = internal::WrapperBase<InvokeType, MP, CP, DP>;
 
-    using TrampolinePtrType = std::conditional_t<dynamicDispatchMethod == DynamicDispatchMethod::FUNC_PTR,
+    using TrampolinePtrType = std::conditional_t<dynamicDispatchMethod == DynamicDispatchMethod::FUNC_PTR ||
+                                                   dynamicDispatchMethod == DynamicDispatchMethod::STATIC_VTABLE,
                                                  typename internal::CallableTypeHelper<FT>::TrampolinePtrType,
                                                  internal::Empty>;
+
+    using LifecycleTablePtrType = std::conditional_t<dynamicDispatchMethod == DynamicDispatchMethod::STATIC_VTABLE,
+                                                     const internal::LifecycleTable*,
+                                                     internal::Empty>;
+
+    // Such Callbacks are copied, moved and destroyed like a plain struct,
+    // which also lets them be passed in registers
+    static constexpr bool triviallyCopyable =
+      (SBOP == SBOPolicy::FIXED_SIZE || SBOP == SBOPolicy::NO_STORAGE || SBOP == SBOPolicy::REFERENCE) &&
+      MP == MovePolicy::TRIVIAL_ONLY && CP == CopyPolicy::TRIVIAL_ONLY && DP == DestroyPolicy::TRIVIAL_ONLY;
 };
 
+// Whether every callable allowed by the source policy is allowed by the target one
+// @{
+constexpr bool
+copyPolicyImplies(CopyPolicy source, CopyPolicy target) noexcept
+{
+    return target == CopyPolicy::NOCOPY || source == CopyPolicy::TRIVIAL_ONLY || source == target;
+}
+
+constexpr bool
+movePolicyImplies(MovePolicy source, MovePolicy target) noexcept
+{
+    switch (target) {
+        case MovePolicy::NOMOVE:
+            return true;
+        case MovePolicy::DYNAMIC:
+            return source != MovePolicy::NOMOVE;
+        case MovePolicy::NOTHROW:
+            return source == MovePolicy::TRIVIAL_ONLY || source == MovePolicy::TRIVIAL_RELOCATION ||
+                   source == MovePolicy::NOTHROW;
+        case MovePolicy::TRIVIAL_RELOCATION:
+            return source == MovePolicy::TRIVIAL_ONLY || source == MovePolicy::TRIVIAL_RELOCATION;
+        case MovePolicy::TRIVIAL_ONLY:
+            return source == MovePolicy::TRIVIAL_ONLY;
+    }
+    return false;
+}
+
+constexpr bool
+destroyPolicyImplies(DestroyPolicy source, DestroyPolicy target) noexcept
+{
+    return target == DestroyPolicy::DYNAMIC || source == DestroyPolicy::TRIVIAL_ONLY;
+}
+// @}
+
 } // namespace internal
 
+// FT is the signature, e.g. int(std::string). noexcept signatures only
+// accept nothrow invocables and const signatures only callables invocable
+// as const; operator() is qualified to match.
 template<typename FT,
          MovePolicy MP,
          CopyPolicy CP,
          DestroyPolicy DP,
          SBOPolicy SBOP,
-         std::size_t InitialBufferSize = 16>
-class Callback;
-
-template<typename RetT,
-         MovePolicy MP,
-         CopyPolicy CP,
-         DestroyPolicy DP,
-         SBOPolicy SBOP,
-         std::size_t InitialBufferSize,
-         typename... Args>
-class Callback<RetT(Args...), MP, CP, DP, SBOP, InitialBufferSize>
-  : private internal::CallbackTraits<RetT(Args...), MP, CP, DP, SBOP, InitialBufferSize>
-  , private internal::StorageBase<
-      typename internal::CallbackTraits<RetT(Args...), MP, CP, DP, SBOP, InitialBufferSize>::StorageT>
-  , private internal::TrampolineBase<
-      typename internal::CallbackTraits<RetT(Args...), MP, CP, DP, SBOP, InitialBufferSize>::TrampolinePtrType>
-  , private internal::FuncPtrBase<
-      typename internal::CallbackTraits<RetT(Args...), MP, CP, DP, SBOP, InitialBufferSize>::FuncPtrType>
+         std::size_t InitialBufferSize = 16,
+         // Used for the heap buffer when SBOP is DYNAMIC_GROWTH or
+         // SHARED_GROWTH and the callable does not fit in InitialBufferSize
+         typename Allocator = std::allocator<unsigned char>,
+         DispatchPolicy DispP = DispatchPolicy::AUTO,
+         // Observes every call when not void: operator() runs
+         //   auto token = InvokeProbe::enter(key);
+         //   ... call the callable ...
+         //   InvokeProbe::exit(key, token);   // also when it throws
+         // key identifies the callable type and can be symbolized: the
+         // trampoline (FUNC_PTR, STATIC_VTABLE), the WrapperImpl vtable
+         // (VIRTCALL) or the function pointer (NO_DISPATCH).
+         // See PolicyCB/LatencyProbe.hpp
+         typename InvokeProbe = void>
+// The callable lives in a byte buffer, but copies of trivially copyable
+// Callbacks are aggregate copies of Callback, which GCC would otherwise assume
+// cannot read the callable's type and drop the stores that construct it
+class POLICYCB_MAY_ALIAS Callback
+  : private internal::CallbackTraits<FT, MP, CP, DP, SBOP, InitialBufferSize, Allocator, DispP>
+  , private internal::CallbackMembers<
+      internal::CallbackTraits<FT, MP, CP, DP, SBOP, InitialBufferSize, Allocator, DispP>>
+  , public internal::CallOperatorBase<Callback<FT, MP, CP, DP, SBOP, InitialBufferSize, Allocator, DispP, InvokeProbe>,
+                                      FT,
+                                      InvokeProbe>
 {
   private:
-    using FT = RetT(Args...);
-    using Traits = internal::CallbackTraits<RetT(Args...), MP, CP, DP, SBOP, InitialBufferSize>;
+    using Traits = internal::CallbackTraits<FT, MP, CP, DP, SBOP, InitialBufferSize, Allocator, DispP>;
     using Traits::dynamicDispatchMethod;
     using typename Traits::DynamicDispatchMethod;
+    using StorageT = typename Traits::StorageT;
+    using MembersT = internal::CallbackMembers<Traits>;
+
+    friend struct internal::CallOperatorBase<Callback, FT, InvokeProbe>;
+    friend struct internal::CallbackAccess;
+
+    template<typename,
+             MovePolicy,
+             CopyPolicy,
+             DestroyPolicy,
+             SBOPolicy,
+             std::size_t,
+             typename,
+             DispatchPolicy,
+             typename>
+    friend class Callback;
+    template<typename>
+    friend struct internal::ProbeScope;
 
   public:
     using type = Traits::type;
     using ReturnType = Traits::ReturnType;
     using ArgsTuple = Traits::ArgsTuple;
     using FuncPtrType = Traits::FuncPtrType;
+    static constexpr DynamicDispatchMethod dispatchMethod = dynamicDispatchMethod;
+    static constexpr MovePolicy movePolicy = MP;
+    static constexpr CopyPolicy copyPolicy = CP;
+    static constexpr DestroyPolicy destroyPolicy = DP;
+    static constexpr SBOPolicy sboPolicy = SBOP;
+    static constexpr std::size_t bufferSize = SBOP == SBOPolicy::REFERENCE ? sizeof(void*) : InitialBufferSize;
+
+    static_assert(SBOP != SBOPolicy::REFERENCE ||
+                    (MP != MovePolicy::DYNAMIC && MP != MovePolicy::NOTHROW && CP != CopyPolicy::DYNAMIC &&
+                     DP != DestroyPolicy::DYNAMIC),
+                  "REFERENCE Callbacks only copy a pointer and need no DYNAMIC policy");
 
   private:
+    // Hooks recording into PolicyCB/SBOProfile.hpp when POLICYCB_SBO_PROFILE
+    // is defined, empty otherwise. Copies and moves of trivially copyable
+    // Callbacks are plain memcpy and are not counted.
+    constexpr void profileConstruction([[maybe_unused]] std::size_t storedSize) const noexcept
+    {
+#ifdef POLICYCB_SBO_PROFILE
+        if (!std::is_constant_evaluated()) {
+            internal::sboProfileCounters<Callback>().recordConstruction(storedSize, this->storage.onHeap());
+        }
+#endif
+    }
+
+    // previousStorage is where the callable lived before a copy assignment,
+    // to tell a reused heap buffer from a new one
+    void profileCopy([[maybe_unused]] const Callback& other,
+                     [[maybe_unused]] const void* previousStorage) const noexcept
+    {
+#ifdef POLICYCB_SBO_PROFILE
+        internal::sboProfileCounters<Callback>().recordCopy(this->storage.onHeap() &&
+                                                            !this->storage.sharesHeapWith(other.storage) &&
+                                                            this->storage.getStorage() != previousStorage);
+#endif
+    }
+
+    void profileCloneAllocation() const noexcept
+    {
+#ifdef POLICYCB_SBO_PROFILE
+        internal::sboProfileCounters<Callback>().recordCloneAllocation();
+#endif
+    }
+
+    void profileMove() const noexcept
+    {
+#ifdef POLICYCB_SBO_PROFILE
+        internal::sboProfileCounters<Callback>().recordMove();
+#endif
+    }
+
     auto getStoredObj() noexcept
     {
-        if constexpr (dynamicDispatchMethod == DynamicDispatchMethod::FUNC_PTR) {
+        if constexpr (dynamicDispatchMethod == DynamicDispatchMethod::FUNC_PTR ||
+                      dynamicDispatchMethod == DynamicDispatchMethod::STATIC_VTABLE) {
             return static_cast<void*>(this->storage.getStorage());
         } else if constexpr (dynamicDispatchMethod == DynamicDispatchMethod::VIRTCALL) {
             return std::launder(reinterpret_cast<Traits::WrapperBaseType*>(this->storage.getStorage()));
@@ -397,7 +1280,8 @@ class Callback<RetT(Args...), MP, CP, DP, SBOP, InitialBufferSize>
 
     auto getStoredObj() const noexcept
     {
-        if constexpr (dynamicDispatchMethod == DynamicDispatchMethod::FUNC_PTR) {
+        if constexpr (dynamicDispatchMethod == DynamicDispatchMethod::FUNC_PTR ||
+                      dynamicDispatchMethod == DynamicDispatchMethod::STATIC_VTABLE) {
             return static_cast<const void*>(this->storage.getStorage());
         } else if constexpr (dynamicDispatchMethod == DynamicDispatchMethod::VIRTCALL) {
             return std::launder(reinterpret_cast<const Traits::WrapperBaseType*>(this->storage.getStorage()));
@@ -408,28 +1292,146 @@ class Callback<RetT(Args...), MP, CP, DP, SBOP, InitialBufferSize>
 
     void destroyStoredObj()
     {
+        if constexpr (SBOP == SBOPolicy::SHARED_GROWTH) {
+            if (this->storage.onHeap() && !this->storage.releaseSharedHeap()) {
+                // Other Callbacks still use the callable
+                return;
+            }
+        }
         if constexpr (dynamicDispatchMethod == DynamicDispatchMethod::NO_DISPATCH ||
                       dynamicDispatchMethod == DynamicDispatchMethod::FUNC_PTR) {
             return;
         } else if constexpr (dynamicDispatchMethod == DynamicDispatchMethod::VIRTCALL) {
             using WrapperBaseType = Traits::WrapperBaseType;
-            (getStoredObj())->~WrapperBaseType();
+            if (holdsStoredObj()) {
+                (getStoredObj())->~WrapperBaseType();
+            }
+        } else if constexpr (dynamicDispatchMethod == DynamicDispatchMethod::STATIC_VTABLE) {
+            if (holdsStoredObj()) {
+                this->lifecycleTable->destroy(getStoredObj());
+            }
         }
     }
 
+    // Whether there is a callable to destroy. Moved-from VIRTCALL Callbacks
+    // have a zeroed vptr, STATIC_VTABLE ones a null lifecycleTable.
+    bool holdsStoredObj() const noexcept
+    {
+        if constexpr (dynamicDispatchMethod == DynamicDispatchMethod::VIRTCALL) {
+            std::size_t vptr;
+            memcpy(&vptr, this->storage.getStorage(), sizeof(vptr));
+            return vptr != 0;
+        } else if constexpr (dynamicDispatchMethod == DynamicDispatchMethod::STATIC_VTABLE) {
+            return this->lifecycleTable != nullptr;
+        } else {
+            return true;
+        }
+    }
+
+    // Leaves a Callback without callable, so that it is not destroyed.
+    // The storage must not be on heap.
+    constexpr void markVacant() noexcept
+    {
+        if constexpr (dynamicDispatchMethod == DynamicDispatchMethod::VIRTCALL) {
+            assert(!this->storage.onHeap());
+            memset(this->storage.getStorage(), 0, sizeof(std::size_t));
+        } else if constexpr (dynamicDispatchMethod == DynamicDispatchMethod::STATIC_VTABLE) {
+            this->lifecycleTable = nullptr;
+        }
+    }
+
+    // Leaves a Callback empty, see operator bool. The storage must not be on
+    // heap.
+    constexpr void markEmpty() noexcept
+    {
+        if constexpr (dynamicDispatchMethod == DynamicDispatchMethod::NO_DISPATCH) {
+            this->funcPtr = nullptr;
+        } else {
+            if constexpr (dynamicDispatchMethod == DynamicDispatchMethod::FUNC_PTR ||
+                          dynamicDispatchMethod == DynamicDispatchMethod::STATIC_VTABLE) {
+                this->trampolinePtr = nullptr;
+            }
+            markVacant();
+        }
+    }
+
+    // For an assignment that threw after destroyStoredObj(): the dispatch
+    // state may still point at the destroyed callable, or at one that was
+    // never constructed, and ~Callback would destroy it
+    void emptyAfterThrow() noexcept
+    {
+        this->storage.resizeTo(0);
+        markEmpty();
+    }
+
+    // Makes room for a callable of ObjT taking size bytes.
+    // MovePolicy::NOTHROW keeps those whose move may throw on the heap, where
+    // moving the Callback only moves the pointer.
+    template<typename ObjT>
+    void resizeFor(std::size_t size)
+    {
+        if constexpr (MP == MovePolicy::NOTHROW && !std::is_nothrow_move_constructible_v<ObjT>) {
+            this->storage.resizeToHeap(size);
+        } else {
+            this->storage.resizeTo(size);
+        }
+    }
+
+    // Makes room for the callable held in other, which stays on the heap if
+    // it is there in a MovePolicy::NOTHROW Callback
+    template<typename OtherStorageT>
+    void resizeLike(const OtherStorageT& other)
+    {
+        if constexpr (MP == MovePolicy::NOTHROW) {
+            if (other.onHeap()) {
+                this->storage.resizeToHeap(other.effectiveBufferSize());
+                return;
+            }
+        }
+        this->storage.resizeTo(other.effectiveBufferSize());
+    }
+
+    // Whether the callable of other can be moved by memcpy
+    bool isRelocatable(const Callback& other) const noexcept
+    {
+        if constexpr (dynamicDispatchMethod == DynamicDispatchMethod::FUNC_PTR ||
+                      MP == MovePolicy::TRIVIAL_RELOCATION) {
+            return true;
+        } else if constexpr (dynamicDispatchMethod == DynamicDispatchMethod::STATIC_VTABLE) {
+            return other.lifecycleTable->moveTo == nullptr;
+        } else {
+            return false;
+        }
+    }
+
+    // Storage must have been prepared with cloneStorage()/cloneStorageFrom()
     void assignFrom(const Callback& other)
     {
         if (this == &other) {
             return;
         }
+        // With SHARED_GROWTH, the storage may already hold the very callable
+        const bool shared = this->storage.sharesHeapWith(other.storage);
         if constexpr (dynamicDispatchMethod == DynamicDispatchMethod::VIRTCALL) {
-            this->storage = other.storage.cloneStorage();
-            other.getStoredObj()->copyTo(getStoredObj());
+            if (shared) {
+                return;
+            } else if (other.holdsStoredObj()) {
+                other.getStoredObj()->copyTo(getStoredObj());
+            } else {
+                markVacant();
+            }
 
         } else if constexpr (dynamicDispatchMethod == DynamicDispatchMethod::FUNC_PTR) {
-            this->storage = other.storage.cloneStorage();
-            memcpy(this->storage.getStorage(), other.storage.getStorage(), this->storage.effectiveBufferSize());
+            if (!shared) {
+                memcpy(this->storage.getStorage(), other.storage.getStorage(), this->storage.effectiveBufferSize());
+            }
+            this->trampolinePtr = other.trampolinePtr;
+        } else if constexpr (dynamicDispatchMethod == DynamicDispatchMethod::STATIC_VTABLE) {
+            if (other.lifecycleTable && !shared) {
+                other.lifecycleTable->copyTo(other.getStoredObj(), getStoredObj());
+            }
             this->trampolinePtr = other.trampolinePtr;
+            this->lifecycleTable = other.lifecycleTable;
         } else {
             this->funcPtr = other.funcPtr;
         }
@@ -437,96 +1439,502 @@ class Callback<RetT(Args...), MP, CP, DP, SBOP, InitialBufferSize>
 
     void moveFrom(Callback&& other)
     {
-        if constexpr (dynamicDispatchMethod == DynamicDispatchMethod::VIRTCALL) {
-            if (other.storage.onHeap()) {
-                this->storage = std::move(other.storage);
-            } else {
-                other.getStoredObj()->moveTo(getStoredObj());
+        if constexpr (dynamicDispatchMethod == DynamicDispatchMethod::NO_DISPATCH) {
+            this->funcPtr = other.funcPtr;
+        } else {
+            if constexpr (dynamicDispatchMethod == DynamicDispatchMethod::FUNC_PTR ||
+                          dynamicDispatchMethod == DynamicDispatchMethod::STATIC_VTABLE) {
+                this->trampolinePtr = other.trampolinePtr;
             }
-        } else if constexpr (dynamicDispatchMethod == DynamicDispatchMethod::FUNC_PTR) {
-            if (other.storage.onHeap()) {
+            if constexpr (dynamicDispatchMethod == DynamicDispatchMethod::STATIC_VTABLE) {
+                this->lifecycleTable = other.lifecycleTable;
+            }
+
+            if (!other.holdsStoredObj()) {
+                this->storage.resizeTo(0);
+                markVacant();
+            } else if (other.storage.onHeap() && this->storage.canAdoptHeapOf(other.storage)) {
                 this->storage = std::move(other.storage);
+                other.markVacant();
             } else {
-                other.getStoredObj()->moveTo(getStoredObj());
+                resizeLike(other.storage);
+                if (isRelocatable(other)) {
+                    memcpy(this->storage.getStorage(), other.storage.getStorage(), this->storage.effectiveBufferSize());
+                    // A heap buffer of another allocator that could not be adopted
+                    other.storage.resizeTo(0);
+                    other.markVacant();
+                } else if constexpr (dynamicDispatchMethod == DynamicDispatchMethod::VIRTCALL) {
+                    std::move(*other.getStoredObj()).moveTo(getStoredObj());
+                } else if constexpr (dynamicDispatchMethod == DynamicDispatchMethod::STATIC_VTABLE) {
+                    other.lifecycleTable->moveTo(other.getStoredObj(), getStoredObj());
+                }
             }
-            this->trampolinePtr = other.trampolinePtr;
+        }
+    }
+
+    // Gives this Callback its own copy of a callable shared through
+    // SBOPolicy::SHARED_GROWTH
+    void unshare()
+    {
+        StorageT ownStorage = this->storage.cloneHeap();
+        if constexpr (dynamicDispatchMethod == DynamicDispatchMethod::VIRTCALL) {
+            getStoredObj()->copyTo(ownStorage.getStorage());
+        } else if constexpr (dynamicDispatchMethod == DynamicDispatchMethod::FUNC_PTR) {
+            memcpy(ownStorage.getStorage(), this->storage.getStorage(), this->storage.effectiveBufferSize());
+        } else if constexpr (dynamicDispatchMethod == DynamicDispatchMethod::STATIC_VTABLE) {
+            this->lifecycleTable->copyTo(getStoredObj(), ownStorage.getStorage());
+        }
+        // The other Callbacks may have let go of it in the meantime
+        destroyStoredObj();
+        this->storage = std::move(ownStorage);
+        profileCloneAllocation();
+    }
+
+    const void* probeKey() const noexcept
+    {
+        if constexpr (dynamicDispatchMethod == DynamicDispatchMethod::NO_DISPATCH) {
+            return reinterpret_cast<const void*>(this->funcPtr);
+        } else if constexpr (dynamicDispatchMethod == DynamicDispatchMethod::FUNC_PTR ||
+                             dynamicDispatchMethod == DynamicDispatchMethod::STATIC_VTABLE) {
+            return reinterpret_cast<const void*>(this->trampolinePtr);
         } else {
-            this->funcPtr = other.funcPtr;
+            const void* vptr;
+            memcpy(&vptr, this->storage.getStorage(), sizeof(vptr));
+            return vptr;
+        }
+    }
+
+    template<typename... CallArgs>
+    constexpr ReturnType invokeStored(CallArgs&&... args) noexcept(internal::CallableTypeHelper<FT>::isNoexcept)
+    {
+        if constexpr (SBOP == SBOPolicy::SHARED_GROWTH && !internal::CallableTypeHelper<FT>::isConst) {
+            if (this->storage.heapShared()) {
+                unshare();
+            }
+        }
+        if constexpr (dynamicDispatchMethod == DynamicDispatchMethod::NO_DISPATCH) {
+            return (*this->funcPtr)(std::forward<CallArgs>(args)...);
+        } else if constexpr (dynamicDispatchMethod == DynamicDispatchMethod::FUNC_PTR ||
+                             dynamicDispatchMethod == DynamicDispatchMethod::STATIC_VTABLE) {
+            return (*this->trampolinePtr)(std::forward<CallArgs>(args)..., getStoredObj());
+        } else if constexpr (dynamicDispatchMethod == DynamicDispatchMethod::VIRTCALL) {
+            return (getStoredObj())->invoke(std::forward<CallArgs>(args)...);
         }
     }
 
-  public:
     template<typename ObjT>
-    explicit Callback(ObjT obj)
+    constexpr void constructFrom(ObjT&& obj)
     {
-        static_assert(internal::CallableTypeHelper<FT>::template satisfiedBy<ObjT&>::value);
+        static_assert(internal::CallableTypeHelper<FT>::template satisfiedBy<ObjT&>::value,
+                      "The callable does not match FT. noexcept signatures need a nothrow invocable callable, "
+                      "const ones a callable invocable as const");
         static_assert(!std::is_same_v<std::decay_t<ObjT>, Callback>);
+        // Null function and member pointers make an empty Callback, as with
+        // std::function
+        if constexpr (std::is_pointer_v<ObjT> || std::is_member_pointer_v<ObjT>) {
+            if (obj == nullptr) {
+                markEmpty();
+                return;
+            }
+        }
+        // Only the traits a policy asks for are instantiated
+        if constexpr (dynamicDispatchMethod != DynamicDispatchMethod::NO_DISPATCH) {
+            if constexpr (CP == CopyPolicy::TRIVIAL_ONLY) {
+                static_assert(std::is_trivially_copyable_v<ObjT>);
+            }
+            if constexpr (MP == MovePolicy::TRIVIAL_ONLY) {
+                static_assert(std::is_trivially_move_constructible_v<ObjT>);
+            } else if constexpr (MP == MovePolicy::TRIVIAL_RELOCATION) {
+                static_assert(isTriviallyRelocatable<ObjT>);
+            } else if constexpr (MP == MovePolicy::NOTHROW && SBOP == SBOPolicy::FIXED_SIZE) {
+                static_assert(std::is_nothrow_move_constructible_v<ObjT>,
+                              "MovePolicy::NOTHROW keeps callables whose move may throw on the heap, which FIXED_SIZE "
+                              "Callbacks do not have");
+            }
+            if constexpr (DP == DestroyPolicy::TRIVIAL_ONLY) {
+                static_assert(std::is_trivially_destructible_v<ObjT>);
+            }
+        }
 
         if constexpr (dynamicDispatchMethod == DynamicDispatchMethod::NO_DISPATCH) {
             static_assert(std::is_convertible_v<ObjT, FuncPtrType>);
             this->funcPtr = static_cast<FuncPtrType>(obj);
-        } else if constexpr (dynamicDispatchMethod == DynamicDispatchMethod::FUNC_PTR) {
+            profileConstruction(0);
+        } else if constexpr (dynamicDispatchMethod == DynamicDispatchMethod::FUNC_PTR ||
+                             dynamicDispatchMethod == DynamicDispatchMethod::STATIC_VTABLE) {
             this->trampolinePtr = &internal::Trampoline<FT, ObjT>::call;
-            static_assert(CP != CopyPolicy::TRIVIAL_ONLY || std::is_trivially_copyable_v<ObjT>);
-            static_assert(MP != MovePolicy::TRIVIAL_ONLY || std::is_trivially_move_constructible_v<ObjT>);
-            static_assert(DP != DestroyPolicy::TRIVIAL_ONLY || std::is_trivially_destructible_v<ObjT>);
-            this->storage.resizeTo(sizeof(ObjT));
             if constexpr (SBOP == SBOPolicy::FIXED_SIZE) {
                 static_assert(sizeof(ObjT) <= InitialBufferSize);
             }
+            if constexpr (dynamicDispatchMethod == DynamicDispatchMethod::FUNC_PTR &&
+                          (SBOP == SBOPolicy::FIXED_SIZE || SBOP == SBOPolicy::REFERENCE)) {
+                if (std::is_constant_evaluated()) {
+                    this->storage.storeConstant(obj);
+                    return;
+                }
+            }
+            resizeFor<ObjT>(sizeof(ObjT));
             new (this->storage.getStorage()) ObjT(std::move(obj));
+            if constexpr (dynamicDispatchMethod == DynamicDispatchMethod::STATIC_VTABLE) {
+                this->lifecycleTable = &internal::lifecycleTable<ObjT, MP, CP>;
+            }
+            profileConstruction(sizeof(ObjT));
         } else {
-            this->storage.resizeTo(sizeof(typename Traits::template StoredObjT<ObjT>));
+            resizeFor<ObjT>(sizeof(typename Traits::template StoredObjT<ObjT>));
             if constexpr (SBOP == SBOPolicy::FIXED_SIZE) {
                 static_assert(sizeof(typename Traits::template StoredObjT<ObjT>) <= InitialBufferSize);
             }
             new (this->storage.getStorage()) Traits::template StoredObjT<ObjT>(std::move(obj));
+            profileConstruction(sizeof(typename Traits::template StoredObjT<ObjT>));
+        }
+    }
+
+    // What a VIRTCALL Callback holds for the callable of a FUNC_PTR OtherCB
+    template<typename OtherCB>
+    using AdoptedPayloadT =
+      internal::TrampolinePayload<typename internal::CallableTypeHelper<FT>::TrampolinePtrType, OtherCB::bufferSize>;
+
+    // Whether the callable of OtherCB can be taken over together with its
+    // trampoline (FUNC_PTR, STATIC_VTABLE) or WrapperImpl (VIRTCALL), so that
+    // calls do not go through OtherCB::operator() first
+    template<typename OtherCB>
+    static constexpr bool canAdopt() noexcept
+    {
+        constexpr MovePolicy otherMP = OtherCB::movePolicy;
+        constexpr CopyPolicy otherCP = OtherCB::copyPolicy;
+        constexpr DestroyPolicy otherDP = OtherCB::destroyPolicy;
+        constexpr bool sameDispatch = OtherCB::dispatchMethod == dynamicDispatchMethod &&
+                                      dynamicDispatchMethod != DynamicDispatchMethod::NO_DISPATCH;
+        // The bytes of a FIXED_SIZE FUNC_PTR callable get a LifecycleTable,
+        // or a WrapperImpl calling their trampoline
+        constexpr bool fromTrivial = OtherCB::dispatchMethod == DynamicDispatchMethod::FUNC_PTR &&
+                                     (OtherCB::sboPolicy == SBOPolicy::FIXED_SIZE ||
+                                      OtherCB::sboPolicy == SBOPolicy::REFERENCE) &&
+                                     (dynamicDispatchMethod == DynamicDispatchMethod::STATIC_VTABLE ||
+                                      dynamicDispatchMethod == DynamicDispatchMethod::VIRTCALL);
+        if constexpr (!sameDispatch && !fromTrivial) {
+            return false;
+        } else if constexpr (dynamicDispatchMethod == DynamicDispatchMethod::VIRTCALL && !fromTrivial &&
+                             (otherMP != MP || otherCP != CP || otherDP != DP)) {
+            // The WrapperImpl would derive from another WrapperBase
+            return false;
+        } else {
+            constexpr bool otherFixed =
+              OtherCB::sboPolicy == SBOPolicy::FIXED_SIZE || OtherCB::sboPolicy == SBOPolicy::REFERENCE;
+            // A VIRTCALL Callback adopting FUNC_PTR bytes also stores their
+            // trampoline and its own vptr
+            constexpr std::size_t adoptedSize =
+              fromTrivial && dynamicDispatchMethod == DynamicDispatchMethod::VIRTCALL
+                ? sizeof(typename Traits::template StoredObjT<AdoptedPayloadT<OtherCB>>)
+                : OtherCB::bufferSize;
+            const bool fits = SBOP != SBOPolicy::FIXED_SIZE || (otherFixed && adoptedSize <= InitialBufferSize);
+            // NOMOVE callables are copied out of other
+            const bool transferable = otherMP != MovePolicy::NOMOVE || otherCP != CopyPolicy::NOCOPY;
+            return fits && transferable && internal::copyPolicyImplies(otherCP, CP) &&
+                   internal::movePolicyImplies(otherMP, MP) && internal::destroyPolicyImplies(otherDP, DP);
+        }
+    }
+
+    template<typename OtherCB>
+    void adoptFrom(OtherCB& other)
+    {
+        if constexpr (OtherCB::dispatchMethod == DynamicDispatchMethod::FUNC_PTR &&
+                      dynamicDispatchMethod == DynamicDispatchMethod::VIRTCALL) {
+            using StoredT = typename Traits::template StoredObjT<AdoptedPayloadT<OtherCB>>;
+            AdoptedPayloadT<OtherCB> payload;
+            payload.trampoline = other.trampolinePtr;
+            memcpy(payload.payload.bytes, other.storage.getStorage(), OtherCB::bufferSize);
+            this->storage.resizeTo(sizeof(StoredT));
+            new (this->storage.getStorage()) StoredT(payload);
+            profileConstruction(sizeof(StoredT));
+        } else if constexpr (OtherCB::dispatchMethod == DynamicDispatchMethod::FUNC_PTR) {
+            this->trampolinePtr = other.trampolinePtr;
+            if constexpr (dynamicDispatchMethod == DynamicDispatchMethod::STATIC_VTABLE) {
+                this->lifecycleTable = &internal::lifecycleTable<internal::TrivialPayload<OtherCB::bufferSize>, MP, CP>;
+            }
+            this->storage.resizeTo(other.storage.effectiveBufferSize());
+            memcpy(this->storage.getStorage(), other.storage.getStorage(), other.storage.effectiveBufferSize());
+            profileConstruction(other.storage.effectiveBufferSize());
+            return;
+        } else {
+            if constexpr (dynamicDispatchMethod == DynamicDispatchMethod::STATIC_VTABLE) {
+                this->trampolinePtr = other.trampolinePtr;
+                this->lifecycleTable = other.lifecycleTable;
+            }
+            if (!other.holdsStoredObj()) {
+                markVacant();
+                return;
+            }
+
+            resizeLike(other.storage);
+            profileConstruction(other.storage.effectiveBufferSize());
+            // Callables still used by copies of other through SHARED_GROWTH stay there
+            const bool mustCopy = OtherCB::movePolicy == MovePolicy::NOMOVE || other.storage.heapShared();
+            if (mustCopy) {
+                if constexpr (OtherCB::copyPolicy != CopyPolicy::NOCOPY) {
+                    if constexpr (dynamicDispatchMethod == DynamicDispatchMethod::VIRTCALL) {
+                        other.getStoredObj()->copyTo(getStoredObj());
+                    } else {
+                        other.lifecycleTable->copyTo(other.getStoredObj(), getStoredObj());
+                    }
+                }
+            } else if (other.isRelocatable(other)) {
+                memcpy(this->storage.getStorage(), other.storage.getStorage(), other.storage.effectiveBufferSize());
+                other.storage.resizeTo(0);
+                other.markVacant();
+            } else if constexpr (dynamicDispatchMethod == DynamicDispatchMethod::VIRTCALL) {
+                std::move(*other.getStoredObj()).moveTo(getStoredObj());
+            } else {
+                other.lifecycleTable->moveTo(other.getStoredObj(), getStoredObj());
+            }
         }
     }
 
-    ReturnType operator()(Args... args)
+  public:
+    // An empty Callback. Its members are zero-filled, with no callable to
+    // construct or destroy, which makes containers of empty Callbacks cheap
+    // to create, resize and tear down. Calling an empty Callback is undefined.
+    constexpr Callback() noexcept
+      : MembersT{}
+    {
+    }
+
+    constexpr Callback(std::nullptr_t) noexcept
+      : Callback()
+    {
+    }
+
+    // constexpr for NO_DISPATCH Callbacks, and for FUNC_PTR ones with
+    // FIXED_SIZE or REFERENCE storage whose callable is empty or has no
+    // padding nor pointers, e.g. a lambda capturing integers. Such Callbacks
+    // can be constinit and make dispatch tables that need no initialization
+    // at startup.
+    template<typename ObjT>
+    constexpr explicit Callback(ObjT obj) requires(SBOP != SBOPolicy::REFERENCE)
+    {
+        constructFrom(std::move(obj));
+    }
+
+    // Refers to obj, or holds it if it is a function pointer. Implicit like
+    // std::function_ref, so that functions taking a REFERENCE Callback can
+    // be passed a lambda directly. constexpr when referring to an object.
+    template<typename ObjT>
+    constexpr Callback(ObjT&& obj)
+      requires(SBOP == SBOPolicy::REFERENCE && !std::is_same_v<std::remove_cvref_t<ObjT>, Callback>)
+    {
+        using DecayedT = std::decay_t<ObjT>;
+        if constexpr (std::is_pointer_v<DecayedT> && std::is_function_v<std::remove_pointer_t<DecayedT>>) {
+            constructFrom(DecayedT(obj));
+        } else {
+            using ReferentT = std::conditional_t<internal::CallableTypeHelper<FT>::isConst,
+                                                 const std::remove_reference_t<ObjT>,
+                                                 std::remove_reference_t<ObjT>>;
+            constructFrom(internal::ObjectRef<ReferentT>{ std::addressof(obj) });
+        }
+    }
+
+    // Converts from a Callback of the same signature. Function pointers are
+    // unwrapped, and callables are taken over with their trampoline or
+    // WrapperImpl whenever both Callbacks dispatch the same way and the
+    // policies of this one accept them. The bytes of FIXED_SIZE FUNC_PTR
+    // callables also go into STATIC_VTABLE and VIRTCALL Callbacks, with
+    // their trampoline. Calls then cost a single indirect jump, plus the vptr
+    // load of VIRTCALL, however many conversions the Callback went through.
+    // Otherwise other is wrapped like any callable.
+    template<MovePolicy OtherMP,
+             CopyPolicy OtherCP,
+             DestroyPolicy OtherDP,
+             SBOPolicy OtherSBOP,
+             std::size_t OtherBufferSize,
+             typename OtherAllocator,
+             DispatchPolicy OtherDispP,
+             typename OtherInvokeProbe>
+    explicit Callback(Callback<FT,
+                               OtherMP,
+                               OtherCP,
+                               OtherDP,
+                               OtherSBOP,
+                               OtherBufferSize,
+                               OtherAllocator,
+                               OtherDispP,
+                               OtherInvokeProbe> other)
+      requires(SBOP != SBOPolicy::REFERENCE && !std::is_same_v<Callback<FT,
+                                                                         OtherMP,
+                                                                         OtherCP,
+                                                                         OtherDP,
+                                                                         OtherSBOP,
+                                                                         OtherBufferSize,
+                                                                         OtherAllocator,
+                                                                         OtherDispP,
+                                                                         OtherInvokeProbe>,
+                                                                Callback>)
+    {
+        using OtherCB = Callback<FT,
+                                 OtherMP,
+                                 OtherCP,
+                                 OtherDP,
+                                 OtherSBOP,
+                                 OtherBufferSize,
+                                 OtherAllocator,
+                                 OtherDispP,
+                                 OtherInvokeProbe>;
+        if (!other) {
+            markEmpty();
+        } else if constexpr (OtherCB::dispatchMethod == DynamicDispatchMethod::NO_DISPATCH) {
+            constructFrom(static_cast<typename OtherCB::FuncPtrType>(other.funcPtr));
+        } else if constexpr (canAdopt<OtherCB>()) {
+            adoptFrom(other);
+        } else {
+            constructFrom(std::move(other));
+        }
+    }
+
+    // Spills to the heap go through the given allocator instead of the
+    // default-constructed one
+    template<typename ObjT>
+    Callback(std::allocator_arg_t, const Allocator& allocator, ObjT obj)
+      : MembersT(StorageT(allocator))
+    {
+        static_assert(SBOP == SBOPolicy::DYNAMIC_GROWTH || SBOP == SBOPolicy::SHARED_GROWTH,
+                      "Only DYNAMIC_GROWTH and SHARED_GROWTH Callbacks allocate");
+        constructFrom(std::move(obj));
+    }
+
+    Allocator getAllocator() const noexcept
+    {
+        return this->storage.getAllocator();
+    }
+
+    // Whether there is a callable. Empty is encoded in what each dispatch
+    // method already stores: a null function pointer (NO_DISPATCH) or
+    // trampoline (FUNC_PTR), a null LifecycleTable (STATIC_VTABLE) or a
+    // zeroed vptr (VIRTCALL). A moved-from Callback is either empty or holds
+    // a moved-from callable.
+    constexpr explicit operator bool() const noexcept
     {
         if constexpr (dynamicDispatchMethod == DynamicDispatchMethod::NO_DISPATCH) {
-            return (*this->funcPtr)(std::forward<Args>(args)...);
+            return this->funcPtr != nullptr;
         } else if constexpr (dynamicDispatchMethod == DynamicDispatchMethod::FUNC_PTR) {
-            return (*this->trampolinePtr)(std::forward<Args>(args)..., getStoredObj());
-        } else if constexpr (dynamicDispatchMethod == DynamicDispatchMethod::VIRTCALL) {
-            return (getStoredObj())->invoke(std::forward<Args>(args)...);
+            return this->trampolinePtr != nullptr;
+        } else {
+            return holdsStoredObj();
         }
     }
 
-    ~Callback()
+    friend constexpr bool operator==(const Callback& cb, std::nullptr_t) noexcept
+    {
+        return !cb;
+    }
+
+    // Destroys the callable and frees the heap buffer, if any
+    void reset() noexcept
+    {
+        destroyStoredObj();
+        this->storage.resizeTo(0);
+        markEmpty();
+    }
+
+    Callback& operator=(std::nullptr_t) noexcept
+    {
+        reset();
+        return *this;
+    }
+
+    ~Callback() requires(Traits::triviallyCopyable) = default;
+    ~Callback() requires(!Traits::triviallyCopyable)
     {
         destroyStoredObj();
     }
 
-    Callback(const std::enable_if_t<CP != CopyPolicy::NOCOPY, Callback>& other)
+    Callback(const Callback&) requires(Traits::triviallyCopyable) = default;
+    Callback& operator=(const Callback&) requires(Traits::triviallyCopyable) = default;
+    Callback(Callback&&) noexcept requires(Traits::triviallyCopyable) = default;
+    Callback& operator=(Callback&&) noexcept requires(Traits::triviallyCopyable) = default;
+
+    Callback(const Callback& other)
+      requires(CP != CopyPolicy::NOCOPY && SBOP != SBOPolicy::NO_STORAGE && !Traits::triviallyCopyable)
+      : MembersT(other.storage.cloneStorage())
+    {
+        assignFrom(other);
+        profileCopy(other, nullptr);
+    }
+
+    // Initializing the empty storage from cloneStorage() crashes GCC 12
+    Callback(const Callback& other)
+      requires(CP != CopyPolicy::NOCOPY && SBOP == SBOPolicy::NO_STORAGE && !Traits::triviallyCopyable)
     {
         assignFrom(other);
+        profileCopy(other, nullptr);
     }
 
-    Callback& operator=(const std::enable_if_t<CP != CopyPolicy::NOCOPY, Callback>& other)
+    Callback& operator=(const Callback& other) requires(CP != CopyPolicy::NOCOPY && !Traits::triviallyCopyable)
     {
         if (this == &other) {
             return *this;
         }
+        const void* previousStorage = this->storage.getStorage();
         destroyStoredObj();
-        assignFrom(other);
+        try {
+            this->storage.cloneStorageFrom(other.storage);
+            assignFrom(other);
+        } catch (...) {
+            emptyAfterThrow();
+            throw;
+        }
+        profileCopy(other, previousStorage);
         return *this;
     }
 
-    Callback& operator=(const std::enable_if_t<MP != MovePolicy::NOMOVE, Callback>&& other)
+    Callback& operator=(Callback&& other) requires(MP != MovePolicy::NOMOVE && !Traits::triviallyCopyable)
     {
         if (this == &other) {
             return *this;
         }
         destroyStoredObj();
-        moveFrom(std::move(other));
+        try {
+            moveFrom(std::move(other));
+        } catch (...) {
+            emptyAfterThrow();
+            throw;
+        }
+        profileMove();
+        return *this;
     }
 
-    Callback(std::enable_if_t<MP != MovePolicy::NOMOVE, Callback>&& other)
+    // Trivially movable callables are moved by memcpy, and the heap buffer is
+    // always adopted since the allocator comes along
+    Callback(Callback&& other) noexcept(MP != MovePolicy::DYNAMIC)
+      requires(MP != MovePolicy::NOMOVE && !Traits::triviallyCopyable)
+      : MembersT(StorageT(other.storage.getAllocator()))
     {
         moveFrom(std::move(other));
-    };
+        profileMove();
+    }
 };
+
+// The std::move_only_function equivalent. Accepts move-only callables such as
+// lambdas capturing a std::unique_ptr, with no copy machinery instantiated.
+// Trivially relocatable callables are moved by memcpy. Moves never throw:
+// callables whose move may throw are kept on the heap, as
+// std::move_only_function does.
+template<typename FT, std::size_t InitialBufferSize = 16>
+using MoveOnlyCallback = Callback<FT,
+                                  MovePolicy::NOTHROW,
+                                  CopyPolicy::NOCOPY,
+                                  DestroyPolicy::DYNAMIC,
+                                  SBOPolicy::DYNAMIC_GROWTH,
+                                  InitialBufferSize,
+                                  std::allocator<unsigned char>,
+                                  DispatchPolicy::STATIC_VTABLE>;
+
+// The std::function_ref equivalent: 16 bytes, never allocates, and copies
+// are a copy of two pointers. The callable must outlive the CallbackRef.
+template<typename FT>
+using CallbackRef = Callback<FT,
+                             MovePolicy::TRIVIAL_ONLY,
+                             CopyPolicy::TRIVIAL_ONLY,
+                             DestroyPolicy::TRIVIAL_ONLY,
+                             SBOPolicy::REFERENCE,
+                             sizeof(void*)>;
+
 }
\ No newline at end of file
@@ -0,0 +1,211 @@
+#pragma once
+
+#include "../PolicyCB.hpp"
+#include "Epoch.hpp"
+
+#include <atomic>
+#include <bit>
+#include <cstdint>
+#include <mutex>
+#include <type_traits>
+#include <utility>
+
+#if defined(__x86_64__) && defined(__AVX__) && defined(__GCC_HAVE_SYNC_COMPARE_AND_SWAP_16)
+#include <immintrin.h>
+#endif
+
+namespace PolicyCB {
+
+namespace internal {
+// 16 bytes read and written as one. On x86-64 with AVX, aligned 16 byte
+// vector loads are single-copy atomic, so readers use one vmovdqa and
+// writers lock cmpxchg16b (build with -mavx -mcx16). Elsewhere a sequence
+// counter validates two 8 byte loads. Either way readers never write, and
+// the cache line stays shared until the next store.
+class AtomicWordPair
+{
+  public:
+    struct Words
+    {
+        std::uint64_t low;
+        std::uint64_t high;
+    };
+
+#if defined(__x86_64__) && defined(__AVX__) && defined(__GCC_HAVE_SYNC_COMPARE_AND_SWAP_16)
+    explicit AtomicWordPair(Words words) noexcept
+      : storage(std::bit_cast<unsigned __int128>(words))
+    {
+    }
+
+    Words load() const noexcept
+    {
+        __m128i value;
+        asm volatile("vmovdqa %1, %0" : "=x"(value) : "m"(storage) : "memory");
+        return std::bit_cast<Words>(value);
+    }
+
+    void store(Words words) noexcept
+    {
+        const auto desired = std::bit_cast<unsigned __int128>(words);
+        auto expected = std::bit_cast<unsigned __int128>(load());
+        for (;;) {
+            const unsigned __int128 previous = __sync_val_compare_and_swap(&storage, expected, desired);
+            if (previous == expected) {
+                return;
+            }
+            expected = previous;
+        }
+    }
+
+  private:
+    alignas(16) unsigned __int128 storage;
+#else
+    explicit AtomicWordPair(Words words) noexcept
+      : low(words.low)
+      , high(words.high)
+    {
+    }
+
+    Words load() const noexcept
+    {
+        for (;;) {
+            const std::uint64_t before = sequence.load(std::memory_order_acquire);
+            const Words words{ low.load(std::memory_order_relaxed), high.load(std::memory_order_relaxed) };
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if ((before & 1) == 0 && sequence.load(std::memory_order_relaxed) == before) {
+                return words;
+            }
+        }
+    }
+
+    // Odd sequence numbers mark a store in progress; they also serialize
+    // concurrent stores
+    void store(Words words) noexcept
+    {
+        std::uint64_t before = sequence.load(std::memory_order_relaxed);
+        while ((before & 1) != 0 || !sequence.compare_exchange_weak(
+                                      before, before + 1, std::memory_order_acquire, std::memory_order_relaxed)) {
+            before = sequence.load(std::memory_order_relaxed);
+        }
+        std::atomic_thread_fence(std::memory_order_release);
+        low.store(words.low, std::memory_order_relaxed);
+        high.store(words.high, std::memory_order_relaxed);
+        sequence.store(before + 2, std::memory_order_release);
+    }
+
+  private:
+    std::atomic<std::uint64_t> sequence{ 0 };
+    std::atomic<std::uint64_t> low;
+    std::atomic<std::uint64_t> high;
+#endif
+};
+
+} // namespace internal
+
+// A Callback slot that worker threads invoke while another thread replaces
+// the callable, without locks on the invoking side.
+//
+// Trivially copyable Callbacks of 8 or 16 bytes (e.g. FUNC_PTR with an 8
+// byte FIXED_SIZE buffer, or NO_DISPATCH) are kept as an atomic snapshot of
+// their bytes: operator() loads it and invokes a copy. Other Callbacks are
+// held on the heap behind an atomic pointer; replaced ones are freed by
+// epoch-based reclamation once no invocation still uses them. Invoking only
+// reads shared cache lines, and writes a per-thread one for heap-held
+// Callbacks.
+//
+// Stores are serialized. Concurrent invocations may run the same heap-held
+// callable concurrently, and one replaced during an invocation finishes it.
+template<typename CallbackT>
+class alignas(internal::cacheLineSize) AtomicCallback
+{
+  public:
+    // Whether the Callback is kept as an atomic snapshot of its bytes
+    static constexpr bool snapshot =
+      std::is_trivially_copyable_v<CallbackT> && (sizeof(CallbackT) == 8 || sizeof(CallbackT) == 16);
+
+  private:
+    using Words = internal::AtomicWordPair::Words;
+    using SnapshotT = std::conditional_t<sizeof(CallbackT) == 8, std::atomic<std::uint64_t>, internal::AtomicWordPair>;
+    using BitsT = std::conditional_t<sizeof(CallbackT) == 8, std::uint64_t, Words>;
+
+    struct HeapState
+    {
+        explicit HeapState(CallbackT* callback) noexcept
+          : current(callback)
+        {
+        }
+
+        std::atomic<CallbackT*> current;
+        std::mutex writerMutex;
+        internal::RetireList<CallbackT> retired;
+    };
+
+    std::conditional_t<snapshot, SnapshotT, HeapState> state;
+
+    static auto makeState(CallbackT&& callback)
+    {
+        if constexpr (snapshot) {
+            return std::bit_cast<BitsT>(callback);
+        } else {
+            return new CallbackT(std::move(callback));
+        }
+    }
+
+  public:
+    template<typename ObjT>
+    explicit AtomicCallback(ObjT obj)
+      : state{ makeState(CallbackT(std::move(obj))) }
+    {
+    }
+
+    AtomicCallback(const AtomicCallback&) = delete;
+    AtomicCallback& operator=(const AtomicCallback&) = delete;
+
+    // No invocation may be running anymore
+    ~AtomicCallback()
+    {
+        if constexpr (!snapshot) {
+            delete state.current.load(std::memory_order_relaxed);
+        }
+    }
+
+    // A copy of the current Callback
+    CallbackT load() const noexcept requires(snapshot)
+    {
+        if constexpr (sizeof(CallbackT) == 8) {
+            return std::bit_cast<CallbackT>(state.load(std::memory_order_acquire));
+        } else {
+            return std::bit_cast<CallbackT>(state.load());
+        }
+    }
+
+    // Replaces the callable. Invocations that already loaded the previous one
+    // still run it.
+    template<typename ObjT>
+    void store(ObjT obj)
+    {
+        if constexpr (snapshot && sizeof(CallbackT) == 8) {
+            state.store(makeState(CallbackT(std::move(obj))), std::memory_order_release);
+        } else if constexpr (snapshot) {
+            state.store(makeState(CallbackT(std::move(obj))));
+        } else {
+            CallbackT* callback = makeState(CallbackT(std::move(obj)));
+            std::lock_guard<std::mutex> lock(state.writerMutex);
+            state.retired.retire(state.current.exchange(callback, std::memory_order_seq_cst));
+        }
+    }
+
+    template<typename... CallArgs>
+    decltype(auto) operator()(CallArgs&&... args) const requires std::is_invocable_v<CallbackT&, CallArgs...>
+    {
+        if constexpr (snapshot) {
+            CallbackT callback = load();
+            return callback(std::forward<CallArgs>(args)...);
+        } else {
+            internal::EpochGuard guard;
+            return (*state.current.load(std::memory_order_acquire))(std::forward<CallArgs>(args)...);
+        }
+    }
+};
+
+} // namespace PolicyCB
@@ -0,0 +1,147 @@
+#pragma once
+
+#include "../PolicyCB.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <functional>
+#include <numeric>
+#include <type_traits>
+#include <vector>
+
+namespace PolicyCB {
+
+// A batch of Callbacks stored as structure-of-arrays: trampoline pointers in
+// one array and payloads in another. Sorting the entries by trampoline with
+// groupByTarget() before invokeAll() makes consecutive calls jump to the same
+// target, which keeps the branch predictor and the I-cache warm.
+//
+// Only FUNC_PTR Callbacks with FIXED_SIZE storage are accepted, since their
+// payload is trivially copyable and of a known size.
+template<typename CallbackT>
+class CallbackBatch;
+
+template<typename RetT,
+         MovePolicy MP,
+         CopyPolicy CP,
+         DestroyPolicy DP,
+         SBOPolicy SBOP,
+         std::size_t InitialBufferSize,
+         typename Allocator,
+         DispatchPolicy DispP,
+         typename InvokeProbe,
+         typename... Args>
+class CallbackBatch<Callback<RetT(Args...), MP, CP, DP, SBOP, InitialBufferSize, Allocator, DispP, InvokeProbe>>
+{
+  public:
+    using CallbackT = Callback<RetT(Args...), MP, CP, DP, SBOP, InitialBufferSize, Allocator, DispP, InvokeProbe>;
+    static_assert(CallbackT::dispatchMethod == DynamicDispatchMethod::FUNC_PTR && SBOP == SBOPolicy::FIXED_SIZE,
+                  "CallbackBatch only holds trivially copyable, fixed-size Callbacks");
+    static_assert(std::is_void_v<InvokeProbe>, "CallbackBatch calls trampolines directly and would bypass the probe");
+
+    // How many entries ahead invokeAll() prefetches payloads
+    static constexpr std::size_t prefetchDistance = 8;
+
+  private:
+    using TrampolinePtrType = typename internal::CallableTypeHelper<RetT(Args...)>::TrampolinePtrType;
+
+    struct Payload
+    {
+        alignas(std::size_t) unsigned char bytes[InitialBufferSize];
+    };
+
+    std::vector<TrampolinePtrType> trampolines;
+    std::vector<Payload> payloads;
+
+  public:
+    std::size_t size() const noexcept
+    {
+        return trampolines.size();
+    }
+
+    bool empty() const noexcept
+    {
+        return trampolines.empty();
+    }
+
+    void reserve(std::size_t capacity)
+    {
+        trampolines.reserve(capacity);
+        payloads.reserve(capacity);
+    }
+
+    void clear() noexcept
+    {
+        trampolines.clear();
+        payloads.clear();
+    }
+
+    // cb must not be empty: invokeAll() would call its null trampoline
+    void push_back(const CallbackT& cb)
+    {
+        assert(cb);
+        Payload& payload = payloads.emplace_back();
+        memcpy(payload.bytes, internal::CallbackAccess::storage(cb), InitialBufferSize);
+        // Keeps both arrays the same size if growing trampolines throws
+        try {
+            trampolines.push_back(internal::CallbackAccess::trampolinePtr(cb));
+        } catch (...) {
+            payloads.pop_back();
+            throw;
+        }
+    }
+
+    template<typename ObjT>
+    void emplace_back(ObjT obj)
+    {
+        push_back(CallbackT{ std::move(obj) });
+    }
+
+    // Stable-sorts the entries by trampoline, so that callbacks sharing a
+    // target are invoked back to back while keeping their relative order
+    void groupByTarget()
+    {
+        std::vector<std::size_t> order(size());
+        std::iota(order.begin(), order.end(), std::size_t{ 0 });
+        std::stable_sort(order.begin(), order.end(), [this](std::size_t lhs, std::size_t rhs) {
+            return std::less<>{}(reinterpret_cast<const void*>(trampolines[lhs]),
+                                 reinterpret_cast<const void*>(trampolines[rhs]));
+        });
+
+        std::vector<TrampolinePtrType> sortedTrampolines;
+        std::vector<Payload> sortedPayloads;
+        sortedTrampolines.reserve(size());
+        sortedPayloads.reserve(size());
+        for (std::size_t idx : order) {
+            sortedTrampolines.push_back(trampolines[idx]);
+            sortedPayloads.push_back(payloads[idx]);
+        }
+        trampolines = std::move(sortedTrampolines);
+        payloads = std::move(sortedPayloads);
+    }
+
+    // Invokes every entry in order, the one of groupByTarget() if it ran. See
+    // internal::fanOut() for how arguments are passed.
+    void invokeAll(Args... args)
+    {
+        const std::size_t count = size();
+        TrampolinePtrType* trampolineIt = trampolines.data();
+        Payload* payloadIt = payloads.data();
+        for (std::size_t i = 0; i < count; ++i) {
+#if defined(__GNUC__)
+            if (i + prefetchDistance < count) {
+                __builtin_prefetch(payloadIt + i + prefetchDistance);
+            }
+#endif
+            (*trampolineIt[i])(internal::fanOut<Args>(args)..., payloadIt[i].bytes);
+        }
+    }
+
+    RetT invoke(std::size_t idx, Args... args)
+    {
+        return (*trampolines[idx])(std::forward<Args>(args)..., payloads[idx].bytes);
+    }
+};
+
+} // namespace PolicyCB
@@ -0,0 +1,166 @@
+#pragma once
+
+#include "../PolicyCB.hpp"
+
+#include <cstddef>
+#include <string_view>
+#include <type_traits>
+
+namespace PolicyCB {
+
+constexpr std::string_view
+toString(DynamicDispatchMethod dispatchMethod) noexcept
+{
+    switch (dispatchMethod) {
+        case DynamicDispatchMethod::NO_DISPATCH:
+            return "NO_DISPATCH";
+        case DynamicDispatchMethod::FUNC_PTR:
+            return "FUNC_PTR";
+        case DynamicDispatchMethod::VIRTCALL:
+            return "VIRTCALL";
+        case DynamicDispatchMethod::STATIC_VTABLE:
+            return "STATIC_VTABLE";
+    }
+    return "";
+}
+
+constexpr std::string_view
+toString(SBOPolicy sboPolicy) noexcept
+{
+    switch (sboPolicy) {
+        case SBOPolicy::DYNAMIC_GROWTH:
+            return "DYNAMIC_GROWTH";
+        case SBOPolicy::FIXED_SIZE:
+            return "FIXED_SIZE";
+        case SBOPolicy::NO_STORAGE:
+            return "NO_STORAGE";
+        case SBOPolicy::SHARED_GROWTH:
+            return "SHARED_GROWTH";
+        case SBOPolicy::REFERENCE:
+            return "REFERENCE";
+    }
+    return "";
+}
+
+namespace internal {
+// A string built at compile time, e.g. "FUNC_PTR dispatch, FIXED_SIZE storage, 8 byte buffer"
+struct ChoiceReport
+{
+    char text[96] = {};
+    std::size_t length = 0;
+
+    constexpr void append(std::string_view str) noexcept
+    {
+        for (char c : str) {
+            text[length++] = c;
+        }
+    }
+
+    constexpr void append(std::size_t number) noexcept
+    {
+        char digits[20] = {};
+        std::size_t digitCount = 0;
+        do {
+            digits[digitCount++] = static_cast<char>('0' + number % 10);
+            number /= 10;
+        } while (number != 0);
+        while (digitCount != 0) {
+            text[length++] = digits[--digitCount];
+        }
+    }
+
+    constexpr std::string_view view() const noexcept
+    {
+        return std::string_view(text, length);
+    }
+};
+
+constexpr std::size_t
+roundUpToWord(std::size_t size) noexcept
+{
+    return size <= sizeof(std::size_t) ? sizeof(std::size_t)
+                                        : (size + sizeof(std::size_t) - 1) / sizeof(std::size_t) * sizeof(std::size_t);
+}
+} // namespace internal
+
+// Picks the cheapest Callback instantiation able to hold an ObjT, in this
+// order:
+// - NO_DISPATCH when ObjT converts to a function pointer, e.g. captureless
+//   lambdas
+// - FUNC_PTR when ObjT is trivially copyable
+// - VIRTCALL otherwise. Copyable if ObjT is, moved by memcpy if ObjT is
+//   trivially relocatable
+// Storage is FIXED_SIZE with the smallest buffer that fits. Callables
+// aligned beyond std::size_t go to a heap buffer instead, which supports
+// up to std::max_align_t.
+//
+// type is the chosen Callback; report describes the choice at compile time,
+// e.g. static_assert(CallbackFor<FT, ObjT>::dispatchMethod == DynamicDispatchMethod::FUNC_PTR)
+template<typename FT, typename ObjT>
+struct CallbackFor
+{
+  private:
+    using InvokeType = typename internal::CallableTypeHelper<FT>::InvokeType;
+
+    static constexpr bool noDispatch = std::is_convertible_v<ObjT, InvokeType*>;
+    static constexpr bool trivial = std::is_trivially_copyable_v<ObjT>;
+
+    static constexpr MovePolicy movePolicy = trivial                         ? MovePolicy::TRIVIAL_ONLY
+                                             : isTriviallyRelocatable<ObjT> ? MovePolicy::TRIVIAL_RELOCATION
+                                                                            : MovePolicy::DYNAMIC;
+    static constexpr CopyPolicy copyPolicy = trivial                              ? CopyPolicy::TRIVIAL_ONLY
+                                             : std::is_copy_constructible_v<ObjT> ? CopyPolicy::DYNAMIC
+                                                                                  : CopyPolicy::NOCOPY;
+    static constexpr DestroyPolicy destroyPolicy = trivial ? DestroyPolicy::TRIVIAL_ONLY : DestroyPolicy::DYNAMIC;
+
+    // What ends up in the buffer: ObjT itself or its WrapperImpl
+    using StoredObjT = typename internal::
+      CallbackTraits<FT, movePolicy, copyPolicy, destroyPolicy, SBOPolicy::FIXED_SIZE>::template StoredObjT<ObjT>;
+
+    static constexpr bool overAligned = alignof(StoredObjT) > alignof(std::size_t);
+    static_assert(alignof(StoredObjT) <= alignof(std::max_align_t),
+                  "Heap buffers are only aligned to std::max_align_t");
+
+  public:
+    static constexpr SBOPolicy sboPolicy = noDispatch    ? SBOPolicy::NO_STORAGE
+                                           : overAligned ? SBOPolicy::DYNAMIC_GROWTH
+                                                         : SBOPolicy::FIXED_SIZE;
+    static constexpr std::size_t bufferSize = noDispatch    ? 0
+                                              : overAligned ? sizeof(std::size_t)
+                                                            : internal::roundUpToWord(sizeof(StoredObjT));
+
+    using type = std::conditional_t<noDispatch,
+                                    Callback<FT,
+                                             MovePolicy::TRIVIAL_ONLY,
+                                             CopyPolicy::TRIVIAL_ONLY,
+                                             DestroyPolicy::TRIVIAL_ONLY,
+                                             SBOPolicy::NO_STORAGE,
+                                             0>,
+                                    Callback<FT, movePolicy, copyPolicy, destroyPolicy, sboPolicy, bufferSize>>;
+
+    static constexpr DynamicDispatchMethod dispatchMethod = type::dispatchMethod;
+
+    static constexpr internal::ChoiceReport report = [] {
+        internal::ChoiceReport result;
+        result.append(toString(dispatchMethod));
+        result.append(" dispatch, ");
+        result.append(toString(sboPolicy));
+        result.append(" storage, ");
+        result.append(bufferSize);
+        result.append(" byte buffer");
+        return result;
+    }();
+};
+
+template<typename FT, typename ObjT>
+using CallbackForT = typename CallbackFor<FT, std::decay_t<ObjT>>::type;
+
+// Wraps obj into the Callback chosen by CallbackFor
+template<typename FT, typename ObjT>
+CallbackForT<FT, ObjT>
+makeCallback(ObjT&& obj)
+{
+    return CallbackForT<FT, ObjT>(std::forward<ObjT>(obj));
+}
+
+} // namespace PolicyCB
@@ -0,0 +1,336 @@
+#pragma once
+
+#include "../PolicyCB.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+namespace PolicyCB {
+
+// An append-only list of callbacks that bump-allocates each callable with its
+// exact size and alignment, right after a one-pointer header, into large
+// chunks. The header points to a static table per callable type holding its
+// trampoline, destructor, size and alignment. Compared to
+// std::vector<Callback> there is no per-element SBO slack and no per-element
+// heap spill: a callable capturing 8 bytes takes 16.
+//
+// Entries are never moved once emplaced, so any callable is accepted.
+template<typename FT, std::size_t ChunkSize = 64 * 1024>
+class CallbackList;
+
+template<typename RetT, std::size_t ChunkSize, typename... Args>
+class CallbackList<RetT(Args...), ChunkSize>
+{
+    using FT = RetT(Args...);
+    using TrampolinePtrType = typename internal::CallableTypeHelper<FT>::TrampolinePtrType;
+
+    struct RecordType
+    {
+        TrampolinePtrType trampoline;
+        // nullptr when the callable is trivially destructible
+        void (*destroy)(void* obj) noexcept;
+        std::uint32_t objAlignment;
+        std::uint32_t objSize;
+    };
+
+    template<typename ObjT>
+    static constexpr RecordType recordType{ &internal::Trampoline<FT, ObjT>::call,
+                                            std::is_trivially_destructible_v<ObjT>
+                                              ? nullptr
+                                              : &internal::LifecycleImpl<ObjT>::destroy,
+                                            alignof(ObjT),
+                                            sizeof(ObjT) };
+
+    // The callable follows at the next multiple of its alignment, the next
+    // header at the next multiple of alignof(RecordHeader) after it
+    struct RecordHeader
+    {
+        const RecordType* type;
+    };
+
+    struct Chunk
+    {
+        unsigned char* buffer;
+        std::size_t capacity;
+        std::size_t used;
+    };
+
+    // alignment must be a power of 2
+    static constexpr std::size_t alignUp(std::size_t pos, std::size_t alignment) noexcept
+    {
+        return (pos + alignment - 1) & ~(alignment - 1);
+    }
+
+    static constexpr std::align_val_t chunkAlignment{ alignof(std::max_align_t) };
+
+    struct ChunkDeleter
+    {
+        void operator()(unsigned char* buffer) const noexcept
+        {
+            ::operator delete(buffer, chunkAlignment);
+        }
+    };
+
+    std::vector<Chunk> chunks;
+    // Index of the chunk emplace() appends to
+    std::size_t currentChunk = 0;
+    std::size_t count = 0;
+    std::size_t nonTrivialCount = 0;
+
+    // Chunks are aligned to alignof(std::max_align_t), so the positions
+    // emplace() aligns within a chunk are aligned addresses
+    static unsigned char* objOf(RecordHeader* header) noexcept
+    {
+        const std::uintptr_t objPos = alignUp(reinterpret_cast<std::uintptr_t>(header) + sizeof(RecordHeader),
+                                              header->type->objAlignment);
+        return reinterpret_cast<unsigned char*>(objPos);
+    }
+
+    // From the header to the next header
+    static std::size_t recordSize(RecordHeader* header) noexcept
+    {
+        const std::size_t objEnd =
+          static_cast<std::size_t>(objOf(header) - reinterpret_cast<unsigned char*>(header)) + header->type->objSize;
+        return alignUp(objEnd, alignof(RecordHeader));
+    }
+
+    static RetT invokeRecord(RecordHeader* header, internal::PassType<Args>... args)
+    {
+        return (*header->type->trampoline)(std::forward<Args>(args)..., objOf(header));
+    }
+
+    void addChunk(std::size_t minCapacity)
+    {
+        // Reuse chunks kept by clear() when they are large enough
+        while (currentChunk + 1 < chunks.size()) {
+            ++currentChunk;
+            if (chunks[currentChunk].capacity >= minCapacity) {
+                return;
+            }
+        }
+        const std::size_t capacity = std::max(ChunkSize, minCapacity);
+        // Freed again if push_back() throws
+        std::unique_ptr<unsigned char, ChunkDeleter> buffer(
+          static_cast<unsigned char*>(::operator new(capacity, chunkAlignment)));
+        chunks.push_back(Chunk{ buffer.get(), capacity, 0 });
+        buffer.release();
+        currentChunk = chunks.size() - 1;
+    }
+
+    void destroyAll() noexcept
+    {
+        if (nonTrivialCount == 0) {
+            return;
+        }
+        for (RecordHeader* header : *this) {
+            if (header->type->destroy) {
+                header->type->destroy(objOf(header));
+            }
+        }
+    }
+
+    void release() noexcept
+    {
+        destroyAll();
+        for (Chunk& chunk : chunks) {
+            ::operator delete(chunk.buffer, chunkAlignment);
+        }
+        chunks.clear();
+    }
+
+  public:
+    // Iterates over the entries in insertion order. Dereferencing yields an
+    // Entry which can be invoked like the callable it refers to.
+    class Entry
+    {
+        RecordHeader* header;
+
+      public:
+        explicit Entry(RecordHeader* header) noexcept
+          : header(header)
+        {
+        }
+
+        operator RecordHeader*() const noexcept
+        {
+            return header;
+        }
+
+        RetT operator()(Args... args) const
+        {
+            return invokeRecord(header, std::forward<Args>(args)...);
+        }
+    };
+
+    class iterator
+    {
+        const std::vector<Chunk>* chunks = nullptr;
+        std::size_t chunkIdx = 0;
+        std::size_t pos = 0;
+
+        void skipExhaustedChunks() noexcept
+        {
+            while (chunkIdx < chunks->size() && pos >= (*chunks)[chunkIdx].used) {
+                ++chunkIdx;
+                pos = 0;
+            }
+        }
+
+      public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = Entry;
+        using difference_type = std::ptrdiff_t;
+        using pointer = void;
+        using reference = Entry;
+
+        iterator() = default;
+        iterator(const std::vector<Chunk>* chunks, std::size_t chunkIdx) noexcept
+          : chunks(chunks)
+          , chunkIdx(chunkIdx)
+        {
+            skipExhaustedChunks();
+        }
+
+        Entry operator*() const noexcept
+        {
+            return Entry(reinterpret_cast<RecordHeader*>((*chunks)[chunkIdx].buffer + pos));
+        }
+
+        iterator& operator++() noexcept
+        {
+            pos += recordSize(reinterpret_cast<RecordHeader*>((*chunks)[chunkIdx].buffer + pos));
+            skipExhaustedChunks();
+            return *this;
+        }
+
+        iterator operator++(int) noexcept
+        {
+            iterator result = *this;
+            ++*this;
+            return result;
+        }
+
+        bool operator==(const iterator& other) const noexcept
+        {
+            return chunkIdx == other.chunkIdx && pos == other.pos;
+        }
+    };
+
+    CallbackList() = default;
+    CallbackList(const CallbackList&) = delete;
+    CallbackList& operator=(const CallbackList&) = delete;
+
+    CallbackList(CallbackList&& other) noexcept
+      : chunks(std::move(other.chunks))
+      , currentChunk(std::exchange(other.currentChunk, 0))
+      , count(std::exchange(other.count, 0))
+      , nonTrivialCount(std::exchange(other.nonTrivialCount, 0))
+    {
+        other.chunks.clear();
+    }
+
+    CallbackList& operator=(CallbackList&& other) noexcept
+    {
+        if (this != &other) {
+            release();
+            chunks = std::move(other.chunks);
+            other.chunks.clear();
+            currentChunk = std::exchange(other.currentChunk, 0);
+            count = std::exchange(other.count, 0);
+            nonTrivialCount = std::exchange(other.nonTrivialCount, 0);
+        }
+        return *this;
+    }
+
+    ~CallbackList()
+    {
+        release();
+    }
+
+    template<typename ObjT>
+    void emplace(ObjT obj)
+    {
+        static_assert(internal::CallableTypeHelper<FT>::template satisfiedBy<ObjT&>::value);
+        static_assert(alignof(ObjT) <= alignof(std::max_align_t), "Over-aligned callables are not supported");
+
+        const std::size_t maxRecordSize = sizeof(RecordHeader) + alignof(ObjT) + sizeof(ObjT) + alignof(RecordHeader);
+        if (chunks.empty() || chunks[currentChunk].capacity - chunks[currentChunk].used < maxRecordSize) {
+            addChunk(maxRecordSize);
+        }
+
+        Chunk& chunk = chunks[currentChunk];
+        const std::size_t headerPos = chunk.used;
+        const std::size_t objPos = alignUp(headerPos + sizeof(RecordHeader), alignof(ObjT));
+        const std::size_t nextPos = alignUp(objPos + sizeof(ObjT), alignof(RecordHeader));
+
+        new (chunk.buffer + objPos) ObjT(std::move(obj));
+        if constexpr (!std::is_trivially_destructible_v<ObjT>) {
+            ++nonTrivialCount;
+        }
+        new (chunk.buffer + headerPos) RecordHeader{ &recordType<ObjT> };
+        chunk.used = nextPos;
+        ++count;
+    }
+
+    // Invokes every entry in insertion order. See internal::fanOut() for how
+    // arguments are passed.
+    void invokeAll(Args... args)
+    {
+        for (const Chunk& chunk : chunks) {
+            for (std::size_t pos = 0; pos < chunk.used;) {
+                auto* header = reinterpret_cast<RecordHeader*>(chunk.buffer + pos);
+                invokeRecord(header, internal::fanOut<Args>(args)...);
+                pos += recordSize(header);
+            }
+        }
+    }
+
+    // Destroys every entry. Chunks are kept for reuse.
+    void clear() noexcept
+    {
+        destroyAll();
+        for (Chunk& chunk : chunks) {
+            chunk.used = 0;
+        }
+        currentChunk = 0;
+        count = 0;
+        nonTrivialCount = 0;
+    }
+
+    iterator begin() const noexcept
+    {
+        return iterator(&chunks, 0);
+    }
+
+    iterator end() const noexcept
+    {
+        return iterator(&chunks, chunks.size());
+    }
+
+    std::size_t size() const noexcept
+    {
+        return count;
+    }
+
+    bool empty() const noexcept
+    {
+        return count == 0;
+    }
+
+    // Bytes taken by headers and callables, excluding the unused chunk tails
+    std::size_t bytesUsed() const noexcept
+    {
+        std::size_t result = 0;
+        for (const Chunk& chunk : chunks) {
+            result += chunk.used;
+        }
+        return result;
+    }
+};
+
+} // namespace PolicyCB
@@ -0,0 +1,211 @@
+#pragma once
+
+#include "../PolicyCB.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace PolicyCB {
+
+// A sibling of Callback that only holds one of the callable types Ts.
+//
+// The callable is stored in a buffer sized for the largest of Ts, next to
+// the index of its type. Calls, copies, moves and destruction dispatch on
+// that index with a chain of comparisons that the optimizer turns into a
+// switch, and every case is a direct, inlinable call. Constructing or
+// assigning a callable that is not one of Ts fails to compile.
+//
+// The policies mean the same as for Callback: TRIVIAL_ONLY ones require all
+// of Ts to qualify and make the matching special member trivial.
+template<typename FT, MovePolicy MP, CopyPolicy CP, DestroyPolicy DP, typename... Ts>
+class ClosedCallback : public internal::CallOperatorBase<ClosedCallback<FT, MP, CP, DP, Ts...>, FT>
+{
+    static_assert(sizeof...(Ts) > 0 && sizeof...(Ts) < 255, "ClosedCallback needs 1 to 254 callable types");
+
+    using IndexT = std::uint8_t;
+    // Index of a ClosedCallback without callable: moved from with
+    // TRIVIAL_RELOCATION, or whose assignment threw
+    static constexpr IndexT vacantIndex = 255;
+
+    template<std::size_t I>
+    using TypeAt = std::tuple_element_t<I, std::tuple<Ts...>>;
+
+    template<typename ObjT>
+    static constexpr std::size_t indexOf() noexcept
+    {
+        constexpr bool matches[] = { std::is_same_v<ObjT, Ts>... };
+        return std::find(std::begin(matches), std::end(matches), true) - std::begin(matches);
+    }
+
+    template<typename ObjT>
+    static constexpr bool checkPolicies() noexcept
+    {
+        static_assert(internal::CallableTypeHelper<FT>::template satisfiedBy<ObjT&>::value,
+                      "The callable does not match FT");
+        static_assert(CP != CopyPolicy::TRIVIAL_ONLY || std::is_trivially_copyable_v<ObjT>);
+        static_assert(CP != CopyPolicy::DYNAMIC || std::is_copy_constructible_v<ObjT>);
+        static_assert(MP != MovePolicy::TRIVIAL_ONLY || std::is_trivially_move_constructible_v<ObjT>);
+        static_assert(MP != MovePolicy::TRIVIAL_RELOCATION || isTriviallyRelocatable<ObjT>);
+        static_assert(MP != MovePolicy::NOTHROW || std::is_nothrow_move_constructible_v<ObjT>,
+                      "ClosedCallback has no heap to keep callables whose move may throw");
+        static_assert(DP != DestroyPolicy::TRIVIAL_ONLY || std::is_trivially_destructible_v<ObjT>);
+        static_assert((std::is_same_v<ObjT, Ts> + ...) == 1, "The callable types must be distinct");
+        return true;
+    }
+    static_assert((checkPolicies<Ts>() && ...));
+
+    alignas(Ts...) unsigned char buffer[std::max({ sizeof(Ts)... })];
+    IndexT index;
+
+    template<typename ObjT>
+    ObjT* get() noexcept
+    {
+        return std::launder(reinterpret_cast<ObjT*>(buffer));
+    }
+
+    template<typename ObjT>
+    const ObjT* get() const noexcept
+    {
+        return std::launder(reinterpret_cast<const ObjT*>(buffer));
+    }
+
+    // Calls visitor.operator()<T>() with the type T at index. The last type
+    // needs no comparison, since index has to be valid.
+    template<std::size_t I = 0, typename Visitor>
+    static decltype(auto) dispatch(IndexT index, Visitor&& visitor)
+    {
+        if constexpr (I + 1 == sizeof...(Ts)) {
+            return visitor.template operator()<TypeAt<I>>();
+        } else {
+            if (index == I) {
+                return visitor.template operator()<TypeAt<I>>();
+            }
+            return dispatch<I + 1>(index, std::forward<Visitor>(visitor));
+        }
+    }
+
+    friend struct internal::CallOperatorBase<ClosedCallback, FT>;
+
+    template<typename... CallArgs>
+    typename internal::CallableTypeHelper<FT>::ReturnType invokeStored(CallArgs&&... args) noexcept(
+      internal::CallableTypeHelper<FT>::isNoexcept)
+    {
+        return dispatch(index, [&]<typename ObjT>() -> typename internal::CallableTypeHelper<FT>::ReturnType {
+            ObjT& obj = *get<ObjT>();
+            if constexpr (internal::CallableTypeHelper<FT>::isConst) {
+                return internal::invoke(std::as_const(obj), std::forward<CallArgs>(args)...);
+            } else {
+                return internal::invoke(obj, std::forward<CallArgs>(args)...);
+            }
+        });
+    }
+
+    // Leaves the ClosedCallback vacant, so that it stays destructible if
+    // constructing its next callable throws
+    void destroy() noexcept
+    {
+        if (index != vacantIndex) {
+            dispatch(index, [this]<typename ObjT>() { std::destroy_at(get<ObjT>()); });
+            index = vacantIndex;
+        }
+    }
+
+    void copyFrom(const ClosedCallback& other)
+    {
+        if (other.index != vacantIndex) {
+            dispatch(other.index, [&]<typename ObjT>() { new (buffer) ObjT(*other.get<ObjT>()); });
+        }
+        index = other.index;
+    }
+
+    void moveFrom(ClosedCallback&& other) noexcept(MP != MovePolicy::DYNAMIC)
+    {
+        if constexpr (MP == MovePolicy::TRIVIAL_RELOCATION) {
+            memcpy(buffer, other.buffer, sizeof(buffer));
+            index = std::exchange(other.index, vacantIndex);
+        } else {
+            if (other.index != vacantIndex) {
+                dispatch(other.index, [&]<typename ObjT>() { new (buffer) ObjT(std::move(*other.get<ObjT>())); });
+            }
+            index = other.index;
+        }
+    }
+
+  public:
+    template<typename ObjT>
+    explicit ClosedCallback(ObjT obj)
+      : index(indexOf<ObjT>())
+    {
+        static_assert(indexOf<ObjT>() < sizeof...(Ts), "The callable is not one of the types of this ClosedCallback");
+        new (buffer) ObjT(std::move(obj));
+    }
+
+    // Replaces the callable, which may be of another of Ts
+    template<typename ObjT>
+    ClosedCallback& operator=(ObjT obj) requires(!std::is_same_v<ObjT, ClosedCallback>)
+    {
+        static_assert(indexOf<ObjT>() < sizeof...(Ts), "The callable is not one of the types of this ClosedCallback");
+        destroy();
+        new (buffer) ObjT(std::move(obj));
+        index = indexOf<ObjT>();
+        return *this;
+    }
+
+    ~ClosedCallback() requires(DP == DestroyPolicy::TRIVIAL_ONLY) = default;
+    ~ClosedCallback() requires(DP != DestroyPolicy::TRIVIAL_ONLY)
+    {
+        destroy();
+    }
+
+    // Trivially copyable callables are trivially destructible, so the
+    // defaulted assignment does not leak
+    ClosedCallback(const ClosedCallback&) requires(CP == CopyPolicy::TRIVIAL_ONLY) = default;
+    ClosedCallback& operator=(const ClosedCallback&) requires(CP == CopyPolicy::TRIVIAL_ONLY) = default;
+
+    ClosedCallback(const ClosedCallback& other) requires(CP == CopyPolicy::DYNAMIC)
+    {
+        copyFrom(other);
+    }
+
+    ClosedCallback& operator=(const ClosedCallback& other) requires(CP == CopyPolicy::DYNAMIC)
+    {
+        if (this != &other) {
+            destroy();
+            copyFrom(other);
+        }
+        return *this;
+    }
+
+    ClosedCallback(ClosedCallback&&) requires(MP == MovePolicy::TRIVIAL_ONLY) = default;
+    ClosedCallback& operator=(ClosedCallback&&) requires(MP == MovePolicy::TRIVIAL_ONLY &&
+                                                         DP == DestroyPolicy::TRIVIAL_ONLY) = default;
+
+    ClosedCallback(ClosedCallback&& other) noexcept(MP != MovePolicy::DYNAMIC)
+      requires(MP == MovePolicy::DYNAMIC || MP == MovePolicy::NOTHROW || MP == MovePolicy::TRIVIAL_RELOCATION)
+    {
+        moveFrom(std::move(other));
+    }
+
+    ClosedCallback& operator=(ClosedCallback&& other) noexcept(MP != MovePolicy::DYNAMIC)
+      requires(MP == MovePolicy::DYNAMIC || MP == MovePolicy::NOTHROW || MP == MovePolicy::TRIVIAL_RELOCATION ||
+               (MP == MovePolicy::TRIVIAL_ONLY && DP != DestroyPolicy::TRIVIAL_ONLY))
+    {
+        if (this != &other) {
+            destroy();
+            moveFrom(std::move(other));
+        }
+        return *this;
+    }
+
+    // Index in Ts of the type of the held callable, or 255 without one
+    std::size_t typeIndex() const noexcept
+    {
+        return index;
+    }
+};
+
+} // namespace PolicyCB
@@ -0,0 +1,139 @@
+#pragma once
+
+#include "../PolicyCB.hpp"
+
+#include <type_traits>
+#include <utility>
+
+namespace PolicyCB {
+
+namespace internal {
+template<typename Ret, bool isNoexcept, typename... Args>
+using FuncPtr = Ret (*)(Args...) noexcept(isNoexcept);
+} // namespace internal
+
+// Stages called in sequence: the first with the call arguments, each next
+// one with the result of the previous one, or with no arguments after a
+// stage returning void. The result is the last stage's.
+//
+// The stages are members laid out one after another, empty ones taking no
+// space, so a Callback holding a Pipeline keeps them all in its one buffer
+// or heap block, and its one trampoline calls them inline:
+//
+//   DynamicCB<void(std::string_view)> handler{ compose(parse, validate, dispatch) };
+//
+// Stages may be Callbacks already. Composing three of them into a fourth
+// puts all three in a single buffer or heap block, and a call costs one
+// indirect call per erased stage, instead of one more per level of
+// wrapping lambdas. Callables that those Callbacks spilled to the heap stay
+// where they are.
+//
+// A Pipeline is trivially copyable if its stages are, and converts to a
+// function pointer if they are all captureless lambdas, which makes
+// makeCallback() pick NO_DISPATCH for it.
+template<typename... Fs>
+class Pipeline;
+
+// Ends the recursion
+template<>
+class Pipeline<>
+{
+  public:
+    static constexpr bool stateless = true;
+};
+
+template<typename F, typename... Rest>
+class Pipeline<F, Rest...>
+{
+    template<typename...>
+    friend class Pipeline;
+
+    [[no_unique_address]] F stage;
+    [[no_unique_address]] Pipeline<Rest...> rest;
+
+    template<typename Self, typename... CallArgs>
+    static constexpr decltype(auto) call(Self& self, CallArgs&&... args)
+    {
+        if constexpr (sizeof...(Rest) == 0) {
+            return internal::invoke(self.stage, std::forward<CallArgs>(args)...);
+        } else if constexpr (std::is_void_v<decltype(internal::invoke(self.stage, std::forward<CallArgs>(args)...))>) {
+            internal::invoke(self.stage, std::forward<CallArgs>(args)...);
+            return self.rest();
+        } else {
+            return self.rest(internal::invoke(self.stage, std::forward<CallArgs>(args)...));
+        }
+    }
+
+  public:
+    // Whether every stage is an empty class
+    static constexpr bool stateless = std::is_empty_v<F> && Pipeline<Rest...>::stateless;
+
+    // Whether the stages chain from CallArgs when called as const if
+    // isConst, and without throwing if nothrow
+    template<bool isConst, bool nothrow, typename... CallArgs>
+    static consteval bool chains()
+    {
+        using StageT = std::conditional_t<isConst, const F, F>&;
+        if constexpr (nothrow ? !std::is_nothrow_invocable_v<StageT, CallArgs...>
+                              : !std::is_invocable_v<StageT, CallArgs...>) {
+            return false;
+        } else if constexpr (sizeof...(Rest) == 0) {
+            return true;
+        } else if constexpr (std::is_void_v<std::invoke_result_t<StageT, CallArgs...>>) {
+            return Pipeline<Rest...>::template chains<isConst, nothrow>();
+        } else {
+            return Pipeline<Rest...>::template chains<isConst, nothrow, std::invoke_result_t<StageT, CallArgs...>>();
+        }
+    }
+
+    constexpr Pipeline() requires(std::is_default_constructible_v<F> &&
+                                  std::is_default_constructible_v<Pipeline<Rest...>>) = default;
+
+    constexpr explicit Pipeline(F first, Rest... others)
+      : stage(std::move(first))
+      , rest(std::move(others)...)
+    {
+    }
+
+    template<typename... CallArgs>
+    constexpr decltype(auto) operator()(CallArgs&&... args) noexcept(chains<false, true, CallArgs...>())
+      requires(chains<false, false, CallArgs...>())
+    {
+        return call(*this, std::forward<CallArgs>(args)...);
+    }
+
+    template<typename... CallArgs>
+    constexpr decltype(auto) operator()(CallArgs&&... args) const noexcept(chains<true, true, CallArgs...>())
+      requires(chains<true, false, CallArgs...>())
+    {
+        return call(*this, std::forward<CallArgs>(args)...);
+    }
+
+    // A function default constructing the stages and calling them. Only for
+    // stages without state, such as captureless lambdas.
+    template<typename Ret, bool isNoexcept, typename... Args>
+      requires(stateless && std::is_default_constructible_v<Pipeline> &&
+               (isNoexcept ? std::is_nothrow_invocable_r_v<Ret, const Pipeline&, Args...>
+                           : std::is_invocable_r_v<Ret, const Pipeline&, Args...>))
+    constexpr operator internal::FuncPtr<Ret, isNoexcept, Args...>() const noexcept
+    {
+        return [](Args... args) noexcept(isNoexcept) -> Ret {
+            return static_cast<Ret>(Pipeline{}(std::forward<Args>(args)...));
+        };
+    }
+};
+
+template<typename... Fs>
+struct IsTriviallyRelocatable<Pipeline<Fs...>> : std::bool_constant<(isTriviallyRelocatable<Fs> && ...)>
+{
+};
+
+// A Pipeline of copies of fs, e.g. compose(parse, validate, dispatch)
+template<typename F, typename... Fs>
+constexpr Pipeline<std::decay_t<F>, std::decay_t<Fs>...>
+compose(F&& f, Fs&&... fs)
+{
+    return Pipeline<std::decay_t<F>, std::decay_t<Fs>...>(std::forward<F>(f), std::forward<Fs>(fs)...);
+}
+
+} // namespace PolicyCB
@@ -0,0 +1,149 @@
+#pragma once
+
+#include "../PolicyCB.hpp"
+
+#include <atomic>
+#include <coroutine>
+#include <optional>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace PolicyCB {
+
+// Resumes a coroutine when invoked. The handle is the only capture, so it
+// fits an 8 byte FIXED_SIZE buffer and calling it is a single jump through
+// the trampoline into coroutine_handle::resume().
+using ResumeCallback = Callback<void(),
+                                MovePolicy::TRIVIAL_ONLY,
+                                CopyPolicy::TRIVIAL_ONLY,
+                                DestroyPolicy::TRIVIAL_ONLY,
+                                SBOPolicy::FIXED_SIZE,
+                                8>;
+
+inline ResumeCallback
+makeResumeCallback(std::coroutine_handle<> handle) noexcept
+{
+    return ResumeCallback{ [handle] { handle.resume(); } };
+}
+
+namespace internal {
+// What co_await on a completion handler of signature void(Args...) yields
+template<typename... Args>
+struct CompletionResult
+{
+    using type = std::tuple<std::decay_t<Args>...>;
+};
+
+template<>
+struct CompletionResult<>
+{
+    using type = void;
+};
+
+template<typename Arg>
+struct CompletionResult<Arg>
+{
+    using type = std::decay_t<Arg>;
+};
+} // namespace internal
+
+// Turns an API that takes a completion Callback into an awaitable.
+// See awaitCallback().
+template<typename CallbackT, typename InitiateFn>
+class CallbackAwaiter;
+
+template<MovePolicy MP,
+         CopyPolicy CP,
+         DestroyPolicy DP,
+         SBOPolicy SBOP,
+         std::size_t InitialBufferSize,
+         typename Allocator,
+         DispatchPolicy DispP,
+         typename InvokeProbe,
+         typename InitiateFn,
+         typename... Args>
+class CallbackAwaiter<Callback<void(Args...), MP, CP, DP, SBOP, InitialBufferSize, Allocator, DispP, InvokeProbe>,
+                      InitiateFn>
+{
+  public:
+    using CallbackT = Callback<void(Args...), MP, CP, DP, SBOP, InitialBufferSize, Allocator, DispP, InvokeProbe>;
+    using ResultT = typename internal::CompletionResult<Args...>::type;
+
+  private:
+    // The completion handler handed to the API. It only captures the
+    // awaiter, which lives in the coroutine frame, so no allocation happens
+    // as long as CallbackT has room for a pointer.
+    struct Completion
+    {
+        CallbackAwaiter* self;
+
+        void operator()(Args... args) const
+        {
+            if constexpr (!std::is_void_v<ResultT>) {
+                self->result.emplace(std::forward<Args>(args)...);
+            }
+            if (self->state.exchange(COMPLETED, std::memory_order_acq_rel) == SUSPENDED) {
+                self->handle.resume();
+            }
+        }
+    };
+
+    // Whichever of await_suspend() and the completion comes second resumes
+    // the coroutine. This covers APIs that complete before returning.
+    enum State
+    {
+        PENDING,
+        COMPLETED,
+        SUSPENDED,
+    };
+
+    struct Empty
+    {};
+
+    InitiateFn initiate;
+    std::coroutine_handle<> handle;
+    std::atomic<State> state{ PENDING };
+    [[no_unique_address]] std::conditional_t<std::is_void_v<ResultT>, Empty, std::optional<ResultT>> result;
+
+  public:
+    explicit CallbackAwaiter(InitiateFn initiate)
+      : initiate(std::move(initiate))
+    {
+    }
+
+    CallbackAwaiter(const CallbackAwaiter&) = delete;
+    CallbackAwaiter& operator=(const CallbackAwaiter&) = delete;
+
+    bool await_ready() const noexcept
+    {
+        return false;
+    }
+
+    bool await_suspend(std::coroutine_handle<> awaitingHandle)
+    {
+        handle = awaitingHandle;
+        std::move(initiate)(CallbackT{ Completion{ this } });
+        return state.exchange(SUSPENDED, std::memory_order_acq_rel) != COMPLETED;
+    }
+
+    ResultT await_resume()
+    {
+        if constexpr (!std::is_void_v<ResultT>) {
+            return std::move(*result);
+        }
+    }
+};
+
+// co_await awaitCallback<CallbackT>(initiate) calls initiate(CallbackT) and
+// suspends until the API invokes the Callback. The arguments it was invoked
+// with become the result of the co_await: nothing for void(), a value for
+// void(T) and a tuple otherwise.
+template<typename CallbackT, typename InitiateFn>
+CallbackAwaiter<CallbackT, InitiateFn>
+awaitCallback(InitiateFn initiate)
+{
+    return CallbackAwaiter<CallbackT, InitiateFn>(std::move(initiate));
+}
+
+} // namespace PolicyCB
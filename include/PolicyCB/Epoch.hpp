@@ -0,0 +1,159 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace PolicyCB {
+
+namespace internal {
+// Keeps readers of neighbouring objects off each other's cache line
+inline constexpr std::size_t cacheLineSize = 64;
+
+// Epoch-based reclamation for objects that readers use without locking,
+// such as the heap-held Callbacks of AtomicCallback and the slot lists of
+// Signal. A reader publishes the global epoch it entered in a record of its
+// own thread, on a cache line of its own, and clears it when it leaves. An
+// object retired in epoch E is freed once no reader is still in an epoch
+// up to E.
+// @{
+struct alignas(cacheLineSize) EpochRecord
+{
+    // 0 when the thread is outside any read
+    std::atomic<std::uint64_t> epoch{ 0 };
+    std::atomic<bool> inUse{ true };
+    EpochRecord* next = nullptr;
+};
+
+inline std::atomic<std::uint64_t> globalEpoch{ 1 };
+// Records are never freed; those of exited threads are reused
+inline std::atomic<EpochRecord*> epochRecords{ nullptr };
+
+class EpochThreadState
+{
+    static EpochRecord* acquireRecord()
+    {
+        for (EpochRecord* record = epochRecords.load(std::memory_order_acquire); record; record = record->next) {
+            bool inUse = false;
+            if (!record->inUse.load(std::memory_order_relaxed) &&
+                record->inUse.compare_exchange_strong(inUse, true, std::memory_order_acquire)) {
+                return record;
+            }
+        }
+        auto* record = new EpochRecord;
+        record->next = epochRecords.load(std::memory_order_relaxed);
+        while (!epochRecords.compare_exchange_weak(
+          record->next, record, std::memory_order_release, std::memory_order_relaxed))
+            ;
+        return record;
+    }
+
+  public:
+    EpochRecord* record = acquireRecord();
+    // Reads nest when a callback reads an epoch-protected object itself
+    unsigned depth = 0;
+
+    EpochThreadState() = default;
+    EpochThreadState(const EpochThreadState&) = delete;
+    EpochThreadState& operator=(const EpochThreadState&) = delete;
+
+    ~EpochThreadState()
+    {
+        record->epoch.store(0, std::memory_order_release);
+        record->inUse.store(false, std::memory_order_release);
+    }
+};
+
+inline EpochThreadState&
+epochThreadState()
+{
+    thread_local EpochThreadState state;
+    return state;
+}
+
+class EpochGuard
+{
+    EpochThreadState& state = epochThreadState();
+
+  public:
+    EpochGuard() noexcept
+    {
+        if (state.depth++ == 0) {
+            state.record->epoch.store(globalEpoch.load(std::memory_order_seq_cst), std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+        }
+    }
+
+    EpochGuard(const EpochGuard&) = delete;
+    EpochGuard& operator=(const EpochGuard&) = delete;
+
+    ~EpochGuard()
+    {
+        if (--state.depth == 0) {
+            state.record->epoch.store(0, std::memory_order_release);
+        }
+    }
+};
+
+// The oldest epoch a reader is still in, or the maximum when there is none
+inline std::uint64_t
+oldestReaderEpoch() noexcept
+{
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    std::uint64_t oldest = std::numeric_limits<std::uint64_t>::max();
+    for (EpochRecord* record = epochRecords.load(std::memory_order_acquire); record; record = record->next) {
+        const std::uint64_t epoch = record->epoch.load(std::memory_order_acquire);
+        if (epoch != 0 && epoch < oldest) {
+            oldest = epoch;
+        }
+    }
+    return oldest;
+}
+
+// Objects unpublished by a writer, deleted once no reader can still use
+// them. Not thread-safe: writers serialize on a lock of their own.
+template<typename T>
+class RetireList
+{
+    struct Retired
+    {
+        T* object;
+        std::uint64_t epoch;
+    };
+
+    std::vector<Retired> retired;
+
+  public:
+    RetireList() = default;
+    RetireList(const RetireList&) = delete;
+    RetireList& operator=(const RetireList&) = delete;
+
+    // No reader may be running anymore
+    ~RetireList()
+    {
+        for (const Retired& entry : retired) {
+            delete entry.object;
+        }
+    }
+
+    // object must have been unpublished already, so that readers entering
+    // from now on cannot find it
+    void retire(T* object)
+    {
+        retired.push_back(Retired{ object, globalEpoch.fetch_add(1, std::memory_order_seq_cst) });
+        const std::uint64_t oldest = oldestReaderEpoch();
+        std::erase_if(retired, [oldest](const Retired& entry) {
+            if (entry.epoch < oldest) {
+                delete entry.object;
+                return true;
+            }
+            return false;
+        });
+    }
+};
+// @}
+} // namespace internal
+
+} // namespace PolicyCB
@@ -0,0 +1,285 @@
+#pragma once
+
+#include "../PolicyCB.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#elif defined(_M_X64) || defined(_M_IX86)
+#include <intrin.h>
+#endif
+
+namespace PolicyCB {
+
+namespace internal {
+// TSC on x86, the virtual counter on AArch64, steady_clock nanoseconds
+// elsewhere
+inline std::uint64_t
+readTicks() noexcept
+{
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+    return __rdtsc();
+#elif defined(__aarch64__)
+    std::uint64_t ticks;
+    asm volatile("mrs %0, cntvct_el0" : "=r"(ticks));
+    return ticks;
+#else
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+#endif
+}
+} // namespace internal
+
+// An InvokeProbe counting the calls of each callable type and timing one
+// call in SampleEvery (per thread) into a log2 latency histogram:
+//
+//   using TracedCB = Callback<void(Event&), ..., DispatchPolicy::AUTO, LatencyProbe<EventLoopTag, 16>>;
+//   ...
+//   LatencyProbe<EventLoopTag, 16>::dump();
+//
+// Each thread records into a table of Capacity entries of its own, keyed by
+// the probe key of the Callback (see Callback), so that probed calls write no
+// memory shared with other threads. snapshot() merges the tables of all
+// threads. Keys beyond Capacity share one overflow entry with a null key. A
+// table takes about Capacity * 560 bytes, is allocated on the first probed
+// call of a thread, and is reused by a later thread once its own exits.
+template<typename Tag = void, std::uint32_t SampleEvery = 1, std::size_t Capacity = 256>
+class LatencyProbe
+{
+    static_assert(SampleEvery > 0);
+    static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of 2");
+
+  public:
+    // Bucket 0 counts sampled calls of 0 ticks, bucket i > 0 those of
+    // 2^(i-1) to 2^i - 1 ticks
+    static constexpr std::size_t bucketCount = 65;
+
+    struct Stats
+    {
+        const void* key;
+        std::uint64_t calls;
+        std::uint64_t sampledCalls;
+        std::uint64_t totalTicks;
+        std::uint64_t maxTicks;
+        std::array<std::uint64_t, bucketCount> histogram;
+
+        // Upper bound of the given quantile of the sampled latencies
+        std::uint64_t quantileTicks(double quantile) const noexcept
+        {
+            std::uint64_t seen = 0;
+            for (std::size_t i = 0; i < bucketCount; ++i) {
+                seen += histogram[i];
+                if (seen != 0 && static_cast<double>(seen) >= quantile * static_cast<double>(sampledCalls)) {
+                    return i == 0 ? 0 : (std::uint64_t(2) << (i - 1)) - 1;
+                }
+            }
+            return maxTicks;
+        }
+    };
+
+  private:
+    // Written by the owning thread only, with a plain load and store rather
+    // than a locked read-modify-write, and read by snapshot()
+    using Counter = std::atomic<std::uint64_t>;
+
+    static void bump(Counter& counter, std::uint64_t by = 1) noexcept
+    {
+        counter.store(counter.load(std::memory_order_relaxed) + by, std::memory_order_relaxed);
+    }
+
+    struct Entry
+    {
+        std::atomic<const void*> key{ nullptr };
+        Counter calls{ 0 };
+        Counter sampledCalls{ 0 };
+        Counter totalTicks{ 0 };
+        Counter maxTicks{ 0 };
+        std::array<Counter, bucketCount> histogram{};
+    };
+
+    struct ThreadTable
+    {
+        Entry entries[Capacity];
+        Entry overflow;
+        std::atomic<bool> inUse{ true };
+        ThreadTable* next = nullptr;
+    };
+
+    // Tables are never freed, so that the counts of exited threads stay in
+    // the report; those of exited threads are reused
+    static inline std::atomic<ThreadTable*> tables{ nullptr };
+
+    static ThreadTable* acquireTable()
+    {
+        for (ThreadTable* table = tables.load(std::memory_order_acquire); table; table = table->next) {
+            bool inUse = false;
+            if (!table->inUse.load(std::memory_order_relaxed) &&
+                table->inUse.compare_exchange_strong(inUse, true, std::memory_order_acquire)) {
+                return table;
+            }
+        }
+        auto* table = new ThreadTable;
+        table->next = tables.load(std::memory_order_relaxed);
+        while (!tables.compare_exchange_weak(table->next, table, std::memory_order_release, std::memory_order_relaxed))
+            ;
+        return table;
+    }
+
+    class TableLease
+    {
+      public:
+        ThreadTable* table = acquireTable();
+
+        TableLease() = default;
+        TableLease(const TableLease&) = delete;
+        TableLease& operator=(const TableLease&) = delete;
+
+        ~TableLease() { table->inUse.store(false, std::memory_order_release); }
+    };
+
+    static ThreadTable& threadTable() noexcept
+    {
+        thread_local TableLease lease;
+        return *lease.table;
+    }
+
+    // Finds or claims the entry of key by linear probing. Only the owning
+    // thread claims keys of its table.
+    static Entry& find(ThreadTable& table, const void* key) noexcept
+    {
+        std::size_t index = (reinterpret_cast<std::uintptr_t>(key) >> 4) * 0x9E3779B97F4A7C15ull;
+        for (std::size_t probe = 0; probe < Capacity; ++probe, ++index) {
+            Entry& entry = table.entries[index & (Capacity - 1)];
+            const void* entryKey = entry.key.load(std::memory_order_relaxed);
+            if (entryKey == key) {
+                return entry;
+            }
+            if (!entryKey) {
+                entry.key.store(key, std::memory_order_release);
+                return entry;
+            }
+        }
+        return table.overflow;
+    }
+
+    static void accumulate(Stats& stats, const Entry& entry) noexcept
+    {
+        stats.calls += entry.calls.load(std::memory_order_relaxed);
+        stats.sampledCalls += entry.sampledCalls.load(std::memory_order_relaxed);
+        stats.totalTicks += entry.totalTicks.load(std::memory_order_relaxed);
+        stats.maxTicks = std::max(stats.maxTicks, entry.maxTicks.load(std::memory_order_relaxed));
+        for (std::size_t i = 0; i < bucketCount; ++i) {
+            stats.histogram[i] += entry.histogram[i].load(std::memory_order_relaxed);
+        }
+    }
+
+  public:
+    // Start of a sampled call, 0 for calls that are only counted
+    using Token = std::uint64_t;
+
+    static Token enter(const void*) noexcept
+    {
+        if constexpr (SampleEvery == 1) {
+            return internal::readTicks();
+        } else {
+            thread_local std::uint32_t countdown = 0;
+            if (countdown-- != 0) {
+                return 0;
+            }
+            countdown = SampleEvery - 1;
+            return internal::readTicks();
+        }
+    }
+
+    static void exit(const void* key, Token start) noexcept
+    {
+        const std::uint64_t end = start ? internal::readTicks() : 0;
+        Entry& entry = find(threadTable(), key);
+        bump(entry.calls);
+        if (!start) {
+            return;
+        }
+        const std::uint64_t ticks = end - start;
+        bump(entry.sampledCalls);
+        bump(entry.totalTicks, ticks);
+        bump(entry.histogram[std::bit_width(ticks)]);
+        if (ticks > entry.maxTicks.load(std::memory_order_relaxed)) {
+            entry.maxTicks.store(ticks, std::memory_order_relaxed);
+        }
+    }
+
+    // Every key seen so far by any thread, plus the overflow entry if it was
+    // used
+    static std::vector<Stats> snapshot()
+    {
+        std::vector<Stats> result;
+        Stats overflow{ nullptr, 0, 0, 0, 0, {} };
+        for (ThreadTable* table = tables.load(std::memory_order_acquire); table; table = table->next) {
+            for (const Entry& entry : table->entries) {
+                const void* key = entry.key.load(std::memory_order_acquire);
+                if (!key) {
+                    continue;
+                }
+                auto stats = std::find_if(result.begin(), result.end(), [key](const Stats& s) { return s.key == key; });
+                if (stats == result.end()) {
+                    stats = result.insert(result.end(), Stats{ key, 0, 0, 0, 0, {} });
+                }
+                accumulate(*stats, entry);
+            }
+            accumulate(overflow, table->overflow);
+        }
+        if (overflow.calls != 0) {
+            result.push_back(overflow);
+        }
+        return result;
+    }
+
+    // Zeroes the counters of every thread. Keys stay claimed. Calls recorded
+    // while resetting may be kept or lost.
+    static void reset() noexcept
+    {
+        auto resetEntry = [](Entry& entry) {
+            for (Counter* counter : { &entry.calls, &entry.sampledCalls, &entry.totalTicks, &entry.maxTicks }) {
+                counter->store(0, std::memory_order_relaxed);
+            }
+            for (Counter& counter : entry.histogram) {
+                counter.store(0, std::memory_order_relaxed);
+            }
+        };
+        for (ThreadTable* table = tables.load(std::memory_order_acquire); table; table = table->next) {
+            for (Entry& entry : table->entries) {
+                resetEntry(entry);
+            }
+            resetEntry(table->overflow);
+        }
+    }
+
+    // One line per key. Keys are code or vtable addresses: feed them to
+    // addr2line or a symbolizer.
+    static void dump(std::FILE* out = stderr)
+    {
+        for (const Stats& stats : snapshot()) {
+            std::fprintf(out,
+                         "%p: %llu calls, %llu sampled, mean %llu, p50 <= %llu, p99 <= %llu, max %llu ticks\n",
+                         stats.key,
+                         static_cast<unsigned long long>(stats.calls),
+                         static_cast<unsigned long long>(stats.sampledCalls),
+                         static_cast<unsigned long long>(stats.sampledCalls ? stats.totalTicks / stats.sampledCalls
+                                                                            : 0),
+                         static_cast<unsigned long long>(stats.quantileTicks(0.5)),
+                         static_cast<unsigned long long>(stats.quantileTicks(0.99)),
+                         static_cast<unsigned long long>(stats.maxTicks));
+        }
+    }
+};
+
+} // namespace PolicyCB
@@ -0,0 +1,24 @@
+#pragma once
+
+#include "../PolicyCB.hpp"
+
+#include <memory_resource>
+
+namespace PolicyCB {
+
+namespace pmr {
+// Callback whose heap spills are served by a std::pmr::memory_resource,
+// e.g. a per-request std::pmr::monotonic_buffer_resource
+template<typename FT,
+         MovePolicy MP,
+         CopyPolicy CP,
+         DestroyPolicy DP,
+         SBOPolicy SBOP,
+         std::size_t InitialBufferSize = 16,
+         DispatchPolicy DispP = DispatchPolicy::AUTO,
+         typename InvokeProbe = void>
+using Callback = PolicyCB::
+  Callback<FT, MP, CP, DP, SBOP, InitialBufferSize, std::pmr::polymorphic_allocator<unsigned char>, DispP, InvokeProbe>;
+} // namespace pmr
+
+} // namespace PolicyCB
@@ -0,0 +1,245 @@
+#pragma once
+
+// Per-instantiation counters of how Callbacks use their storage. Included
+// by PolicyCB.hpp when POLICYCB_SBO_PROFILE is defined; without it the hooks
+// in Callback are empty and nothing here is compiled. The macro has to be
+// defined the same way in every translation unit.
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string_view>
+#include <vector>
+
+namespace PolicyCB {
+
+// What sboProfileSnapshot() reports for one Callback instantiation
+struct SBOProfileEntry
+{
+    // Capture sizes are bucketed by word: bucket i counts stored callables
+    // of (i - 1) * 8 + 1 to i * 8 bytes, the last one everything larger
+    static constexpr std::size_t bucketWidth = sizeof(std::size_t);
+    static constexpr std::size_t bucketCount = 33;
+
+    std::string_view name;
+    std::size_t bufferSize;
+    // Callables stored, by constructor or conversion
+    std::uint64_t constructions;
+    // Constructions that did not fit bufferSize and went to the heap
+    std::uint64_t heapSpills;
+    std::uint64_t copies;
+    std::uint64_t moves;
+    // Copies that allocated a heap buffer of their own, including SHARED_GROWTH
+    // Callbacks unsharing on a call
+    std::uint64_t cloneAllocations;
+    std::array<std::uint64_t, bucketCount> sizeHistogram;
+
+    // The smallest buffer size that would have held the given fraction of
+    // the stored callables without spilling
+    std::size_t bufferSizeFor(double fraction) const noexcept
+    {
+        std::uint64_t covered = 0;
+        for (std::size_t i = 0; i < bucketCount; ++i) {
+            covered += sizeHistogram[i];
+            if (static_cast<double>(covered) >= fraction * static_cast<double>(constructions)) {
+                return i * bucketWidth;
+            }
+        }
+        return bucketCount * bucketWidth;
+    }
+};
+
+namespace internal {
+template<typename T>
+constexpr std::string_view
+typeName() noexcept
+{
+#if defined(_MSC_VER)
+    std::string_view name = __FUNCSIG__;
+    const std::size_t begin = name.find("typeName<") + 9;
+    return name.substr(begin, name.rfind(">(") - begin);
+#else
+    // "... [with T = Callback<...>; ...]" on GCC, "... [T = Callback<...>]" on Clang
+    std::string_view name = __PRETTY_FUNCTION__;
+    const std::size_t begin = name.find("T = ") + 4;
+    std::size_t end = name.find(';', begin);
+    if (end == std::string_view::npos) {
+        end = name.rfind(']');
+    }
+    return name.substr(begin, end - begin);
+#endif
+}
+
+class SBOProfileCounters;
+
+// Head of the list of every SBOProfileCounters created so far. Counters are
+// only ever added, so readers can walk the list without locking.
+inline std::atomic<SBOProfileCounters*> sboProfileHead{ nullptr };
+
+class SBOProfileCounters
+{
+    using Counter = std::atomic<std::uint64_t>;
+
+    std::string_view name;
+    std::size_t bufferSize;
+    Counter constructions{ 0 };
+    Counter heapSpills{ 0 };
+    Counter copies{ 0 };
+    Counter moves{ 0 };
+    Counter cloneAllocations{ 0 };
+    std::array<Counter, SBOProfileEntry::bucketCount> sizeHistogram{};
+    SBOProfileCounters* next;
+
+    static void bump(Counter& counter) noexcept
+    {
+        counter.fetch_add(1, std::memory_order_relaxed);
+    }
+
+  public:
+    SBOProfileCounters(std::string_view name, std::size_t bufferSize) noexcept
+      : name(name)
+      , bufferSize(bufferSize)
+      , next(sboProfileHead.load(std::memory_order_relaxed))
+    {
+        while (!sboProfileHead.compare_exchange_weak(next, this, std::memory_order_release, std::memory_order_relaxed))
+            ;
+    }
+
+    SBOProfileCounters(const SBOProfileCounters&) = delete;
+    SBOProfileCounters& operator=(const SBOProfileCounters&) = delete;
+
+    void recordConstruction(std::size_t storedSize, bool spilled) noexcept
+    {
+        bump(constructions);
+        if (spilled) {
+            bump(heapSpills);
+        }
+        const std::size_t bucket = (storedSize + SBOProfileEntry::bucketWidth - 1) / SBOProfileEntry::bucketWidth;
+        bump(sizeHistogram[bucket < SBOProfileEntry::bucketCount ? bucket : SBOProfileEntry::bucketCount - 1]);
+    }
+
+    void recordCopy(bool allocated) noexcept
+    {
+        bump(copies);
+        if (allocated) {
+            bump(cloneAllocations);
+        }
+    }
+
+    void recordCloneAllocation() noexcept
+    {
+        bump(cloneAllocations);
+    }
+
+    void recordMove() noexcept
+    {
+        bump(moves);
+    }
+
+    SBOProfileEntry snapshot() const noexcept
+    {
+        SBOProfileEntry entry{ name,
+                               bufferSize,
+                               constructions.load(std::memory_order_relaxed),
+                               heapSpills.load(std::memory_order_relaxed),
+                               copies.load(std::memory_order_relaxed),
+                               moves.load(std::memory_order_relaxed),
+                               cloneAllocations.load(std::memory_order_relaxed),
+                               {} };
+        for (std::size_t i = 0; i < SBOProfileEntry::bucketCount; ++i) {
+            entry.sizeHistogram[i] = sizeHistogram[i].load(std::memory_order_relaxed);
+        }
+        return entry;
+    }
+
+    void reset() noexcept
+    {
+        for (Counter* counter : { &constructions, &heapSpills, &copies, &moves, &cloneAllocations }) {
+            counter->store(0, std::memory_order_relaxed);
+        }
+        for (Counter& counter : sizeHistogram) {
+            counter.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    const SBOProfileCounters* getNext() const noexcept
+    {
+        return next;
+    }
+
+    SBOProfileCounters* getNext() noexcept
+    {
+        return next;
+    }
+};
+
+// Created and registered on the first construction of a CallbackT
+template<typename CallbackT>
+SBOProfileCounters&
+sboProfileCounters() noexcept
+{
+    static SBOProfileCounters counters(typeName<CallbackT>(), CallbackT::bufferSize);
+    return counters;
+}
+} // namespace internal
+
+// Counters of every Callback instantiation constructed so far
+inline std::vector<SBOProfileEntry>
+sboProfileSnapshot()
+{
+    std::vector<SBOProfileEntry> entries;
+    for (const internal::SBOProfileCounters* counters = internal::sboProfileHead.load(std::memory_order_acquire);
+         counters;
+         counters = counters->getNext()) {
+        entries.push_back(counters->snapshot());
+    }
+    return entries;
+}
+
+inline void
+resetSBOProfile() noexcept
+{
+    for (internal::SBOProfileCounters* counters = internal::sboProfileHead.load(std::memory_order_acquire); counters;
+         counters = counters->getNext()) {
+        counters->reset();
+    }
+}
+
+// One block per instantiation: the counters, the non-empty histogram
+// buckets and the buffer sizes that would avoid 99% and all spills
+inline void
+dumpSBOProfile(std::FILE* out = stderr)
+{
+    for (const SBOProfileEntry& entry : sboProfileSnapshot()) {
+        std::fprintf(out,
+                     "%.*s\n  buffer %zu bytes: %llu constructions, %llu heap spills, %llu copies (%llu allocating), "
+                     "%llu moves\n  capture sizes:",
+                     static_cast<int>(entry.name.size()),
+                     entry.name.data(),
+                     entry.bufferSize,
+                     static_cast<unsigned long long>(entry.constructions),
+                     static_cast<unsigned long long>(entry.heapSpills),
+                     static_cast<unsigned long long>(entry.copies),
+                     static_cast<unsigned long long>(entry.cloneAllocations),
+                     static_cast<unsigned long long>(entry.moves));
+        for (std::size_t i = 0; i < SBOProfileEntry::bucketCount; ++i) {
+            if (entry.sizeHistogram[i] == 0) {
+                continue;
+            }
+            if (i + 1 == SBOProfileEntry::bucketCount) {
+                std::fprintf(out, " >%zu: ", (i - 1) * SBOProfileEntry::bucketWidth);
+            } else {
+                std::fprintf(out, " <=%zu: ", i * SBOProfileEntry::bucketWidth);
+            }
+            std::fprintf(out, "%llu", static_cast<unsigned long long>(entry.sizeHistogram[i]));
+        }
+        std::fprintf(out,
+                     "\n  buffer for 99%%: %zu bytes, for all: %zu bytes\n",
+                     entry.bufferSizeFor(0.99),
+                     entry.bufferSizeFor(1));
+    }
+}
+
+} // namespace PolicyCB
@@ -0,0 +1,163 @@
+#pragma once
+
+#include "../PolicyCB.hpp"
+#include "Epoch.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace PolicyCB {
+
+// A multicast signal whose slots are Callbacks of type CallbackT.
+//
+// The slot list is an immutable snapshot published through an atomic
+// pointer. emit() loads the current snapshot and calls every slot in it
+// without taking a lock nor writing any shared cache line, so emitting
+// threads do not slow each other down. connect() and disconnect() serialize
+// on a writer mutex, copy the snapshot and publish the new one; replaced
+// snapshots are freed by epoch-based reclamation once no emit() still reads
+// them. Slots are held by shared_ptr, so copying a snapshot never copies a
+// Callback.
+//
+// A slot may still be called by an emit() that loaded its snapshot before the
+// slot was disconnected. Concurrent emits may call the same slot concurrently.
+template<typename CallbackT>
+class Signal;
+
+template<typename RetT,
+         MovePolicy MP,
+         CopyPolicy CP,
+         DestroyPolicy DP,
+         SBOPolicy SBOP,
+         std::size_t InitialBufferSize,
+         typename Allocator,
+         DispatchPolicy DispP,
+         typename InvokeProbe,
+         typename... Args>
+class Signal<Callback<RetT(Args...), MP, CP, DP, SBOP, InitialBufferSize, Allocator, DispP, InvokeProbe>>
+{
+  public:
+    using CallbackT = Callback<RetT(Args...), MP, CP, DP, SBOP, InitialBufferSize, Allocator, DispP, InvokeProbe>;
+
+    // Identifies a slot for disconnect(). A default-constructed Connection
+    // refers to no slot.
+    class Connection
+    {
+        friend class Signal;
+        std::uint64_t id = 0;
+
+        explicit Connection(std::uint64_t id) noexcept
+          : id(id)
+        {
+        }
+
+      public:
+        Connection() = default;
+
+        bool connected() const noexcept
+        {
+            return id != 0;
+        }
+
+        bool operator==(const Connection&) const noexcept = default;
+    };
+
+  private:
+    struct Slot
+    {
+        std::uint64_t id;
+        std::shared_ptr<CallbackT> callback;
+    };
+    using Snapshot = std::vector<Slot>;
+
+    // Read by every emit(), written by connect() and disconnect() only
+    alignas(internal::cacheLineSize) std::atomic<const Snapshot*> snapshot{ new Snapshot() };
+    alignas(internal::cacheLineSize) std::mutex writerMutex;
+    internal::RetireList<const Snapshot> retired;
+    std::uint64_t nextId = 1;
+
+    // Must be called with writerMutex held
+    void publish(const Snapshot* next)
+    {
+        retired.retire(snapshot.exchange(next, std::memory_order_seq_cst));
+    }
+
+  public:
+    Signal() = default;
+    Signal(const Signal&) = delete;
+    Signal& operator=(const Signal&) = delete;
+
+    // No emit() may be running anymore
+    ~Signal()
+    {
+        delete snapshot.load(std::memory_order_relaxed);
+    }
+
+    template<typename ObjT>
+    Connection connect(ObjT obj)
+    {
+        auto callback = std::make_shared<CallbackT>(std::move(obj));
+        std::lock_guard<std::mutex> lock(writerMutex);
+        auto next = std::make_unique<Snapshot>(*snapshot.load(std::memory_order_relaxed));
+        const std::uint64_t id = nextId++;
+        next->push_back(Slot{ id, std::move(callback) });
+        publish(next.release());
+        return Connection(id);
+    }
+
+    // Returns false if the slot was not connected
+    bool disconnect(Connection& connection)
+    {
+        if (!connection.connected()) {
+            return false;
+        }
+        std::lock_guard<std::mutex> lock(writerMutex);
+        const Snapshot* current = snapshot.load(std::memory_order_relaxed);
+        auto it = std::find_if(
+          current->begin(), current->end(), [&](const Slot& slot) { return slot.id == connection.id; });
+        connection = Connection();
+        if (it == current->end()) {
+            return false;
+        }
+        auto next = std::make_unique<Snapshot>();
+        next->reserve(current->size() - 1);
+        next->insert(next->end(), current->begin(), it);
+        next->insert(next->end(), it + 1, current->end());
+        publish(next.release());
+        return true;
+    }
+
+    void disconnectAll()
+    {
+        std::lock_guard<std::mutex> lock(writerMutex);
+        publish(new Snapshot());
+    }
+
+    // Calls every slot of the current snapshot in connection order. See
+    // internal::fanOut() for how arguments are passed.
+    void emit(Args... args) const
+    {
+        internal::EpochGuard guard;
+        const Snapshot* current = snapshot.load(std::memory_order_acquire);
+        for (const Slot& slot : *current) {
+            (*slot.callback)(internal::fanOut<Args>(args)...);
+        }
+    }
+
+    void operator()(Args... args) const
+    {
+        emit(std::forward<Args>(args)...);
+    }
+
+    std::size_t slotCount() const noexcept
+    {
+        internal::EpochGuard guard;
+        return snapshot.load(std::memory_order_acquire)->size();
+    }
+};
+
+} // namespace PolicyCB
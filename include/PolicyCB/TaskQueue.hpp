@@ -0,0 +1,225 @@
+#pragma once
+
+#include "../PolicyCB.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <thread>
+
+namespace PolicyCB {
+
+// What TaskQueue::push() does when every ring slot is taken
+enum class OverflowPolicy
+{
+    // Spin (yielding) until the consumer frees a slot
+    BLOCK = 0,
+    // Move the task into a mutex-protected overflow deque. Only this path
+    // allocates; producers keep spilling until the consumer drained it, so
+    // the order of each producer's tasks is kept
+    SPILL = 1,
+    // Drop the task and make push() return false
+    REJECT = 2,
+};
+
+// A bounded lock-free multi-producer/single-consumer queue of Callbacks.
+//
+// Each of the Capacity ring slots holds a Callback in place. push()
+// constructs the Callback directly in its slot and the consumer invokes and
+// destroys it there, so neither side touches the allocator (unless the
+// overflow policy is SPILL and the ring is full). Slots are claimed and
+// published with a per-slot sequence number, as in Vyukov's bounded queue.
+//
+// Only FIXED_SIZE Callbacks are accepted, since a heap spill of the capture
+// would defeat the purpose.
+template<typename CallbackT, std::size_t Capacity, OverflowPolicy OP = OverflowPolicy::BLOCK>
+class TaskQueue;
+
+template<typename RetT,
+         MovePolicy MP,
+         CopyPolicy CP,
+         DestroyPolicy DP,
+         SBOPolicy SBOP,
+         std::size_t InitialBufferSize,
+         typename Allocator,
+         DispatchPolicy DispP,
+         typename InvokeProbe,
+         std::size_t Capacity,
+         OverflowPolicy OP,
+         typename... Args>
+class TaskQueue<Callback<RetT(Args...), MP, CP, DP, SBOP, InitialBufferSize, Allocator, DispP, InvokeProbe>,
+                Capacity,
+                OP>
+{
+  public:
+    using CallbackT = Callback<RetT(Args...), MP, CP, DP, SBOP, InitialBufferSize, Allocator, DispP, InvokeProbe>;
+    static_assert(SBOP == SBOPolicy::FIXED_SIZE, "TaskQueue only holds FIXED_SIZE Callbacks");
+    static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of 2");
+    static_assert(OP != OverflowPolicy::SPILL || MP != MovePolicy::NOMOVE,
+                  "Spilled tasks are moved out of the overflow deque");
+
+  private:
+    // Keeps producers claiming neighbouring slots off each other's cache line
+    static constexpr std::size_t cacheLineSize = 64;
+
+    struct alignas(cacheLineSize) Slot
+    {
+        // pos: free for the producer claiming pos. pos + 1: holds a task
+        // for the consumer reading pos
+        std::atomic<std::size_t> sequence;
+        alignas(CallbackT) unsigned char buffer[sizeof(CallbackT)];
+
+        CallbackT* callback() noexcept
+        {
+            return std::launder(reinterpret_cast<CallbackT*>(buffer));
+        }
+    };
+
+    // Destroys the task and hands the slot back to producers, even if
+    // invoking the task threw
+    struct SlotRelease
+    {
+        Slot& slot;
+        std::size_t pos;
+
+        ~SlotRelease()
+        {
+            std::destroy_at(slot.callback());
+            slot.sequence.store(pos + Capacity, std::memory_order_release);
+        }
+    };
+
+    std::unique_ptr<Slot[]> slots{ new Slot[Capacity] };
+    alignas(cacheLineSize) std::atomic<std::size_t> enqueuePos{ 0 };
+    alignas(cacheLineSize) std::size_t dequeuePos = 0;
+
+    std::mutex overflowMutex;
+    std::deque<CallbackT> overflow;
+    std::atomic<std::size_t> overflowSize{ 0 };
+
+    template<typename ObjT>
+    bool tryPushToRing(ObjT& obj)
+    {
+        std::size_t pos = enqueuePos.load(std::memory_order_relaxed);
+        for (;;) {
+            Slot& slot = slots[pos & (Capacity - 1)];
+            const std::size_t seq = slot.sequence.load(std::memory_order_acquire);
+            const auto diff = static_cast<std::intptr_t>(seq) - static_cast<std::intptr_t>(pos);
+            if (diff == 0) {
+                if (enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    new (slot.buffer) CallbackT(std::move(obj));
+                    slot.sequence.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = enqueuePos.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    template<typename ObjT>
+    void spill(ObjT& obj)
+    {
+        std::lock_guard<std::mutex> lock(overflowMutex);
+        overflow.emplace_back(std::move(obj));
+        overflowSize.fetch_add(1, std::memory_order_release);
+    }
+
+    // A producer only spills after its earlier tasks claimed their ring
+    // slots, so the overflow waits until the ring is empty, slots claimed
+    // but not published yet included
+    bool runOverflowOne(Args&&... args)
+    {
+        if (overflowSize.load(std::memory_order_acquire) == 0 ||
+            enqueuePos.load(std::memory_order_relaxed) != dequeuePos) {
+            return false;
+        }
+        std::unique_lock<std::mutex> lock(overflowMutex);
+        CallbackT task(std::move(overflow.front()));
+        overflow.pop_front();
+        overflowSize.fetch_sub(1, std::memory_order_release);
+        lock.unlock();
+        task(std::forward<Args>(args)...);
+        return true;
+    }
+
+  public:
+    TaskQueue()
+    {
+        for (std::size_t i = 0; i < Capacity; ++i) {
+            slots[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    TaskQueue(const TaskQueue&) = delete;
+    TaskQueue& operator=(const TaskQueue&) = delete;
+
+    ~TaskQueue()
+    {
+        for (;; ++dequeuePos) {
+            Slot& slot = slots[dequeuePos & (Capacity - 1)];
+            if (slot.sequence.load(std::memory_order_acquire) != dequeuePos + 1) {
+                break;
+            }
+            std::destroy_at(slot.callback());
+        }
+    }
+
+    // Thread-safe. Returns false only when the task was rejected.
+    // ObjT must be nothrow move constructible: a claimed slot has to be
+    // published, or the consumer would wait on it forever.
+    template<typename ObjT>
+    bool push(ObjT obj)
+    {
+        static_assert(std::is_nothrow_move_constructible_v<ObjT>, "Tasks must be nothrow move constructible");
+        if constexpr (OP == OverflowPolicy::SPILL) {
+            if (overflowSize.load(std::memory_order_acquire) != 0 || !tryPushToRing(obj)) {
+                spill(obj);
+            }
+            return true;
+        } else if constexpr (OP == OverflowPolicy::REJECT) {
+            return tryPushToRing(obj);
+        } else {
+            while (!tryPushToRing(obj)) {
+                std::this_thread::yield();
+            }
+            return true;
+        }
+    }
+
+    // Consumer only. Invokes and destroys the oldest task, if any. Return
+    // values are discarded. Returns false while the oldest task is still
+    // being pushed.
+    bool runOne(Args... args)
+    {
+        Slot& slot = slots[dequeuePos & (Capacity - 1)];
+        if (slot.sequence.load(std::memory_order_acquire) != dequeuePos + 1) {
+            if constexpr (OP == OverflowPolicy::SPILL) {
+                return runOverflowOne(std::forward<Args>(args)...);
+            } else {
+                return false;
+            }
+        }
+        SlotRelease release{ slot, dequeuePos++ };
+        (*slot.callback())(std::forward<Args>(args)...);
+        return true;
+    }
+
+    // Consumer only. Runs tasks until the queue is observed empty. See
+    // internal::fanOut() for how arguments are passed. Returns how many ran.
+    std::size_t runAll(Args... args)
+    {
+        std::size_t ran = 0;
+        while (runOne(internal::fanOut<Args>(args)...)) {
+            ++ran;
+        }
+        return ran;
+    }
+};
+
+} // namespace PolicyCB
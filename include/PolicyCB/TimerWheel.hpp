@@ -0,0 +1,325 @@
+#pragma once
+
+#include "../PolicyCB.hpp"
+
+#include <bit>
+#include <cassert>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <vector>
+
+namespace PolicyCB {
+
+// A hashed hierarchical timing wheel of Callbacks.
+//
+// Time is counted in ticks chosen by the caller. Each of the Levels wheels
+// has 2^SlotBits slots; a slot of level l covers 2^(SlotBits * l) ticks. A
+// timer goes to the lowest level whose span reaches its deadline, and is
+// moved down a level ("cascaded") when the slot it sits in comes up. Timers
+// further out than the top level wait in its furthest slot.
+//
+// Slots are intrusive doubly linked lists of nodes carved out of slabs of
+// 1024, recycled through a free list, and each node holds its Callback in
+// place. schedule() and cancel() are O(1) and only allocate when every
+// node is taken; advance() expires every due timer in one pass, skipping
+// empty slots with an occupancy bitmap.
+//
+// Not thread-safe. Callbacks may schedule and cancel timers, but not call
+// advance().
+template<typename CallbackT, unsigned SlotBits = 8, unsigned Levels = 4>
+class TimerWheel;
+
+template<typename RetT,
+         MovePolicy MP,
+         CopyPolicy CP,
+         DestroyPolicy DP,
+         SBOPolicy SBOP,
+         std::size_t InitialBufferSize,
+         typename Allocator,
+         DispatchPolicy DispP,
+         typename InvokeProbe,
+         unsigned SlotBits,
+         unsigned Levels,
+         typename... Args>
+class TimerWheel<Callback<RetT(Args...), MP, CP, DP, SBOP, InitialBufferSize, Allocator, DispP, InvokeProbe>,
+                 SlotBits,
+                 Levels>
+{
+  public:
+    using CallbackT = Callback<RetT(Args...), MP, CP, DP, SBOP, InitialBufferSize, Allocator, DispP, InvokeProbe>;
+    static_assert(SlotBits >= 6 && SlotBits <= 16, "Slots are tracked by 64 bit occupancy words");
+    static_assert(Levels >= 1 && SlotBits * Levels < 64);
+
+  private:
+    static constexpr std::size_t slotCount = std::size_t(1) << SlotBits;
+    static constexpr std::uint64_t slotMask = slotCount - 1;
+    static constexpr std::size_t wordsPerLevel = slotCount / 64;
+    // The furthest a timer can be placed; later ones are cascaded again
+    static constexpr std::uint64_t maxDelta = (std::uint64_t(1) << (SlotBits * Levels)) - 1;
+    static constexpr std::size_t nodesPerSlab = 1024;
+
+    struct Node
+    {
+        Node* next;
+        Node* prev;
+        std::uint64_t when;
+        // Bumped when the timer fires or is cancelled, so that stale
+        // TimerIds are told apart from the node's next timer
+        std::uint32_t generation;
+        // level * slotCount + slot index
+        std::uint32_t bucket;
+        alignas(CallbackT) unsigned char buffer[sizeof(CallbackT)];
+
+        CallbackT* callback() noexcept
+        {
+            return std::launder(reinterpret_cast<CallbackT*>(buffer));
+        }
+    };
+
+  public:
+    // Refers to a scheduled timer. Remains safe to pass to cancel() after
+    // the timer fired or was cancelled.
+    class TimerId
+    {
+        friend class TimerWheel;
+
+        Node* node = nullptr;
+        std::uint32_t generation = 0;
+
+        TimerId(Node* node, std::uint32_t generation) noexcept
+          : node(node)
+          , generation(generation)
+        {
+        }
+
+      public:
+        TimerId() = default;
+    };
+
+  private:
+    // Destroys the callback and recycles the node, even if invoking it threw
+    struct NodeRelease
+    {
+        TimerWheel& wheel;
+        Node* node;
+
+        ~NodeRelease()
+        {
+            std::destroy_at(node->callback());
+            wheel.freeNode(node);
+        }
+    };
+
+    Node* heads[Levels * slotCount] = {};
+    std::uint64_t occupied[Levels * wordsPerLevel] = {};
+    std::vector<std::unique_ptr<Node[]>> slabs;
+    Node* freeList = nullptr;
+    std::uint64_t currentTick = 0;
+    std::size_t count = 0;
+
+    Node* allocateNode()
+    {
+        if (!freeList) {
+            std::unique_ptr<Node[]> slab(new Node[nodesPerSlab]);
+            for (std::size_t i = 0; i < nodesPerSlab; ++i) {
+                slab[i].generation = 0;
+                slab[i].next = i + 1 < nodesPerSlab ? &slab[i + 1] : nullptr;
+            }
+            // If push_back throws, the slab is freed and freeList still empty
+            slabs.push_back(std::move(slab));
+            freeList = slabs.back().get();
+        }
+        Node* node = freeList;
+        freeList = node->next;
+        return node;
+    }
+
+    void freeNode(Node* node) noexcept
+    {
+        node->next = freeList;
+        freeList = node;
+    }
+
+    // Puts node in the slot its deadline falls in. A deadline of now goes to
+    // the current level 0 slot, which only happens when cascading.
+    void link(Node* node) noexcept
+    {
+        const std::uint64_t delta = node->when - currentTick < maxDelta ? node->when - currentTick : maxDelta;
+        const unsigned level = delta <= slotMask ? 0 : (std::bit_width(delta) - 1) / SlotBits;
+        const std::size_t bucket = level * slotCount + (((currentTick + delta) >> (SlotBits * level)) & slotMask);
+        node->bucket = static_cast<std::uint32_t>(bucket);
+        node->prev = nullptr;
+        node->next = heads[bucket];
+        if (node->next) {
+            node->next->prev = node;
+        }
+        heads[bucket] = node;
+        occupied[bucket / 64] |= std::uint64_t(1) << (bucket % 64);
+    }
+
+    void unlink(Node* node) noexcept
+    {
+        if (node->prev) {
+            node->prev->next = node->next;
+        } else {
+            heads[node->bucket] = node->next;
+            if (!node->next) {
+                occupied[node->bucket / 64] &= ~(std::uint64_t(1) << (node->bucket % 64));
+            }
+        }
+        if (node->next) {
+            node->next->prev = node->prev;
+        }
+    }
+
+    // The first occupied level 0 slot from index on, or slotCount
+    std::size_t nextOccupiedSlot(std::size_t index) const noexcept
+    {
+        for (std::size_t word = index / 64; word < wordsPerLevel; ++word) {
+            std::uint64_t bits = occupied[word];
+            if (word == index / 64) {
+                bits &= ~std::uint64_t(0) << (index % 64);
+            }
+            if (bits) {
+                return word * 64 + std::countr_zero(bits);
+            }
+        }
+        return slotCount;
+    }
+
+    // At the start of a level 0 rotation, moves the timers of the upper
+    // level slots coming up now down. The top level goes first so that its
+    // timers can land in lower slots cascaded right after.
+    void cascade() noexcept
+    {
+        for (unsigned level = Levels - 1; level > 0; --level) {
+            const unsigned shift = SlotBits * level;
+            if ((currentTick & ((std::uint64_t(1) << shift) - 1)) != 0) {
+                continue;
+            }
+            const std::size_t bucket = level * slotCount + ((currentTick >> shift) & slotMask);
+            Node* node = heads[bucket];
+            heads[bucket] = nullptr;
+            occupied[bucket / 64] &= ~(std::uint64_t(1) << (bucket % 64));
+            while (node) {
+                Node* next = node->next;
+                link(node);
+                node = next;
+            }
+        }
+    }
+
+  public:
+    TimerWheel() = default;
+
+    TimerWheel(const TimerWheel&) = delete;
+    TimerWheel& operator=(const TimerWheel&) = delete;
+
+    ~TimerWheel()
+    {
+        for (Node* head : heads) {
+            for (Node* node = head; node; node = node->next) {
+                std::destroy_at(node->callback());
+            }
+        }
+    }
+
+    std::uint64_t now() const noexcept
+    {
+        return currentTick;
+    }
+
+    // Number of pending timers
+    std::size_t size() const noexcept
+    {
+        return count;
+    }
+
+    bool empty() const noexcept
+    {
+        return count == 0;
+    }
+
+    // Runs obj at the first advance() past tick when. Deadlines not after
+    // now() fire at the next tick.
+    template<typename ObjT>
+    TimerId scheduleAt(std::uint64_t when, ObjT obj)
+    {
+        Node* node = allocateNode();
+        try {
+            new (node->buffer) CallbackT(std::move(obj));
+        } catch (...) {
+            freeNode(node);
+            throw;
+        }
+        node->when = when > currentTick ? when : currentTick + 1;
+        link(node);
+        ++count;
+        return TimerId(node, node->generation);
+    }
+
+    template<typename ObjT>
+    TimerId scheduleAfter(std::uint64_t delay, ObjT obj)
+    {
+        return scheduleAt(currentTick + delay, std::move(obj));
+    }
+
+    // Returns false when the timer already fired, is firing or was cancelled
+    bool cancel(TimerId id) noexcept
+    {
+        if (!id.node || id.node->generation != id.generation) {
+            return false;
+        }
+        Node* node = id.node;
+        unlink(node);
+        ++node->generation;
+        --count;
+        std::destroy_at(node->callback());
+        freeNode(node);
+        return true;
+    }
+
+    // Moves time forward to tick to, firing every timer due by then in
+    // deadline order; timers due at the same tick fire in no particular
+    // order. See internal::fanOut() for how arguments are passed. Returns how
+    // many timers fired.
+    std::size_t advance(std::uint64_t to, Args... args)
+    {
+        std::size_t fired = 0;
+        while (currentTick < to) {
+            if (count == 0) {
+                currentTick = to;
+                break;
+            }
+            // The next tick with anything to do: an occupied level 0 slot, or
+            // the start of the next rotation where upper levels cascade
+            const std::uint64_t rotationStart = currentTick & ~slotMask;
+            const std::size_t nextIndex = (currentTick + 1) & slotMask;
+            std::uint64_t next = rotationStart + slotCount;
+            if (nextIndex != 0) {
+                next = rotationStart + nextOccupiedSlot(nextIndex);
+            }
+            if (next > to) {
+                currentTick = to;
+                break;
+            }
+            currentTick = next;
+            if ((currentTick & slotMask) == 0) {
+                cascade();
+            }
+            Node** head = &heads[currentTick & slotMask];
+            while (Node* node = *head) {
+                unlink(node);
+                ++node->generation;
+                --count;
+                NodeRelease release{ *this, node };
+                (*node->callback())(internal::fanOut<Args>(args)...);
+                ++fired;
+            }
+        }
+        return fired;
+    }
+};
+
+} // namespace PolicyCB
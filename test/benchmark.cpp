@@ -1,7 +1,27 @@
 #include "PolicyCB.hpp"
+#include "PolicyCB/AtomicCallback.hpp"
+#include "PolicyCB/CallbackBatch.hpp"
+#include "PolicyCB/CallbackFor.hpp"
+#include "PolicyCB/CallbackList.hpp"
+#include "PolicyCB/ClosedCallback.hpp"
+#include "PolicyCB/Compose.hpp"
+#include "PolicyCB/Coroutine.hpp"
+#include "PolicyCB/Pmr.hpp"
+#include "PolicyCB/Signal.hpp"
+#include "PolicyCB/TaskQueue.hpp"
+#include "PolicyCB/TimerWheel.hpp"
 #include <catch2/benchmark/catch_benchmark.hpp>
 #include <catch2/catch_test_macros.hpp>
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <memory_resource>
+#include <mutex>
+#include <queue>
+#include <random>
+#include <shared_mutex>
 #include <string>
+#include <thread>
 #include <vector>
 
 using namespace std;
@@ -80,6 +100,27 @@ template<typename FT>
 using FixedDynamicCB =
   Callback<FT, MovePolicy::DYNAMIC, CopyPolicy::DYNAMIC, DestroyPolicy::DYNAMIC, SBOPolicy::FIXED_SIZE, 16>;
 
+// Same as the above two, but copy/move/destroy go through a static table
+// per callable and calls through an inline trampoline. 40/32 bytes.
+template<typename FT>
+using VtableDynamicCB = Callback<FT,
+                                 MovePolicy::DYNAMIC,
+                                 CopyPolicy::DYNAMIC,
+                                 DestroyPolicy::DYNAMIC,
+                                 SBOPolicy::DYNAMIC_GROWTH,
+                                 16,
+                                 std::allocator<unsigned char>,
+                                 DispatchPolicy::STATIC_VTABLE>;
+template<typename FT>
+using FixedVtableDynamicCB = Callback<FT,
+                                      MovePolicy::DYNAMIC,
+                                      CopyPolicy::DYNAMIC,
+                                      DestroyPolicy::DYNAMIC,
+                                      SBOPolicy::FIXED_SIZE,
+                                      16,
+                                      std::allocator<unsigned char>,
+                                      DispatchPolicy::STATIC_VTABLE>;
+
 // Only allows trivially-copyable invocables to optimize
 // calls. Faster to call than the above variant at the cost
 // of slightly more memory.
@@ -121,9 +162,40 @@ using FunctionRef = Callback<FT,
                              SBOPolicy::NO_STORAGE,
                              0>;
 
+// DynamicCB whose heap spills go through a std::pmr::memory_resource
+template<typename FT>
+using PmrDynamicCB = PolicyCB::pmr::
+  Callback<FT, MovePolicy::DYNAMIC, CopyPolicy::DYNAMIC, DestroyPolicy::DYNAMIC, SBOPolicy::DYNAMIC_GROWTH, 16>;
+
+// Moves are a memcpy of the buffer and never destroy the source.
+template<typename FT>
+using RelocatingCB = Callback<FT,
+                              MovePolicy::TRIVIAL_RELOCATION,
+                              CopyPolicy::NOCOPY,
+                              DestroyPolicy::DYNAMIC,
+                              SBOPolicy::DYNAMIC_GROWTH,
+                              16,
+                              std::allocator<unsigned char>,
+                              DispatchPolicy::STATIC_VTABLE>;
+
+// DynamicCB whose heap-resident callables are shared by its copies
+template<typename FT>
+using SharedCB =
+  Callback<FT, MovePolicy::DYNAMIC, CopyPolicy::DYNAMIC, DestroyPolicy::DYNAMIC, SBOPolicy::SHARED_GROWTH, 16>;
+
+// Only holds the listed callable types, which it calls directly
+template<typename FT, typename... Ts>
+using ClosedTrivialCB =
+  ClosedCallback<FT, MovePolicy::TRIVIAL_ONLY, CopyPolicy::TRIVIAL_ONLY, DestroyPolicy::TRIVIAL_ONLY, Ts...>;
+
 template<typename FT>
 using StdFunction = std::function<FT>;
 
+#ifdef __cpp_lib_move_only_function
+template<typename FT>
+using StdMoveOnlyFunction = std::move_only_function<FT>;
+#endif
+
 template<typename CBType, typename ObjVecT, typename... AdditionalArgsT>
 int
 runBenchmark(const ObjVecT& objVec, AdditionalArgsT&&... additionalArgs)
@@ -168,6 +240,86 @@ runBenchmark(const ObjVecT& objVec, AdditionalArgsT&&... additionalArgs)
     return temp;
 }
 
+// Constructs callbacks that spill to the heap through the allocator returned
+// by makeAllocator(), which is called once per benchmark run
+template<typename CBType, typename ObjVecT, typename MakeAllocatorT>
+int
+runSpillBenchmark(const ObjVecT& objVec, MakeAllocatorT&& makeAllocator)
+{
+    int temp = 2;
+
+    BENCHMARK("Construction and destruction of 100000 spilled callbacks")
+    {
+        auto allocator = makeAllocator();
+        std::vector<CBType> cbVec;
+        cbVec.reserve(100000);
+        for (int i = 0; i < 100000; ++i) {
+            cbVec.emplace_back(std::allocator_arg, allocator, objVec[i % objVec.size()]);
+            ++temp;
+        }
+        return temp;
+    };
+
+    BENCHMARK("Construction and calls of 1000 spilled callbacks, 100 rounds")
+    {
+        for (int round = 0; round < 100; ++round) {
+            auto allocator = makeAllocator();
+            std::vector<CBType> cbVec;
+            cbVec.reserve(1000);
+            for (int i = 0; i < 1000; ++i) {
+                cbVec.emplace_back(std::allocator_arg, allocator, objVec[i % objVec.size()]);
+            }
+            for (auto& cb : cbVec) {
+                temp += cb("hello"s, "world!"s);
+            }
+        }
+        return temp;
+    };
+
+    return temp;
+}
+
+// For callbacks that can't be copied. makeObj(i) returns the i-th callable
+template<typename CBType, typename MakeObjT>
+int
+runMoveOnlyBenchmark(MakeObjT&& makeObj)
+{
+    int temp = 2;
+
+    BENCHMARK("Growth of a vector to 100000 callbacks")
+    {
+        std::vector<CBType> cbVec;
+        for (int i = 0; i < 100000; ++i) {
+            cbVec.emplace_back(makeObj(i));
+            ++temp;
+        }
+        return temp;
+    };
+
+    std::vector<CBType> cbVec;
+    for (int i = 0; i < 400; ++i) {
+        cbVec.emplace_back(makeObj(i));
+    }
+
+    BENCHMARK("Random calls on 400 callbacks")
+    {
+        for (int i = 0; i < 1000000; ++i) {
+            temp += cbVec[std::rand() % 400]("hello"s, "world!"s);
+        }
+    };
+
+    BENCHMARK("Random moves and calls on 400 callbacks")
+    {
+        for (int i = 0; i < 1000000; ++i) {
+            int nowIdx = std::rand() % 400;
+            std::swap(cbVec[nowIdx], cbVec[std::rand() % 400]);
+            temp += cbVec[nowIdx]("hello2"s, "world!"s);
+        }
+    };
+
+    return temp;
+}
+
 TEST_CASE("Small obj benchmarks")
 {
     vector<int (*)(string, string)> objVec{ f1, f2, f3, f4, f5 };
@@ -181,6 +333,14 @@ TEST_CASE("Small obj benchmarks")
     {
         runBenchmark<FixedDynamicCB<FT>>(objVec);
     }
+    SECTION("Vtable Dynamic CB")
+    {
+        runBenchmark<VtableDynamicCB<FT>>(objVec);
+    }
+    SECTION("Fixed Vtable Dynamic CB")
+    {
+        runBenchmark<FixedVtableDynamicCB<FT>>(objVec);
+    }
     SECTION("Trivial CB")
     {
         runBenchmark<TrivialCB<FT>>(objVec);
@@ -193,6 +353,10 @@ TEST_CASE("Small obj benchmarks")
     {
         runBenchmark<FunctionRef<FT>>(objVec);
     }
+    SECTION("Auto-selected CB")
+    {
+        runBenchmark<CallbackForT<FT, int (*)(string, string)>>(objVec);
+    }
     SECTION("Std Function")
     {
         runBenchmark<StdFunction<FT>>(objVec);
@@ -222,6 +386,14 @@ TEST_CASE("Mid obj benchmarks")
     {
         runBenchmark<FixedDynamicCB<FT>>(mids);
     }
+    SECTION("Vtable Dynamic CB")
+    {
+        runBenchmark<VtableDynamicCB<FT>>(mids);
+    }
+    SECTION("Fixed Vtable Dynamic CB")
+    {
+        runBenchmark<FixedVtableDynamicCB<FT>>(mids);
+    }
     SECTION("Trivial CB")
     {
         runBenchmark<TrivialCB<FT>>(mids);
@@ -230,12 +402,58 @@ TEST_CASE("Mid obj benchmarks")
     {
         runBenchmark<FixedTrivialCB<FT>>(mids);
     }
+    SECTION("Closed Trivial CB")
+    {
+        runBenchmark<ClosedTrivialCB<FT, Mid>>(mids);
+    }
+    SECTION("Auto-selected CB")
+    {
+        runBenchmark<CallbackForT<FT, Mid>>(mids);
+    }
     SECTION("Std Function")
     {
         runBenchmark<StdFunction<FT>>(mids);
     }
 }
 
+TEST_CASE("Mixed lambda benchmarks")
+{
+    int cnts[4] = { 0, 0, 5, 2 };
+    using FT = int(string, string);
+
+    auto countUp = [cnt = cnts](const string& a, const string& b) { return (*cnt)++; };
+    auto countDown = [cnt = cnts + 1](const string& a, const string& b) { return (*cnt)--; };
+    auto addSize = [cnt = cnts + 2](const string& a, const string& b) { return *cnt += a.size(); };
+    auto compareSizes = [cnt = cnts + 3](const string& a, const string& b) { return *cnt + (a.size() < b.size()); };
+    // Each CB type gets the four lambdas in turn, so that calls through
+    // random indices hit all of them and ClosedCallback dispatches on its
+    // type index for real
+    auto makeCallbacks = [&]<typename CBType>() {
+        return vector<CBType>{ CBType{ countUp }, CBType{ countDown }, CBType{ addSize }, CBType{ compareSizes } };
+    };
+    SECTION("Dynamic CB")
+    {
+        runBenchmark<DynamicCB<FT>>(makeCallbacks.template operator()<DynamicCB<FT>>());
+    }
+    SECTION("Fixed Trivial CB")
+    {
+        runBenchmark<FixedTrivialCB<FT>>(makeCallbacks.template operator()<FixedTrivialCB<FT>>());
+    }
+    SECTION("Closed Trivial CB")
+    {
+        using ClosedCB = ClosedTrivialCB<FT,
+                                         decltype(countUp),
+                                         decltype(countDown),
+                                         decltype(addSize),
+                                         decltype(compareSizes)>;
+        runBenchmark<ClosedCB>(makeCallbacks.template operator()<ClosedCB>());
+    }
+    SECTION("Std Function")
+    {
+        runBenchmark<StdFunction<FT>>(makeCallbacks.template operator()<StdFunction<FT>>());
+    }
+}
+
 TEST_CASE("Member function pointer")
 {
     int cnt = 0;
@@ -249,10 +467,22 @@ TEST_CASE("Member function pointer")
     {
         runBenchmark<DynamicCB<FT>>(memPtrs, &mid);
     }
+    SECTION("Vtable Dynamic CB")
+    {
+        runBenchmark<VtableDynamicCB<FT>>(memPtrs, &mid);
+    }
     SECTION("Big Trivial CB")
     {
         runBenchmark<BigTrivialCB<FT>>(memPtrs, &mid);
     }
+    SECTION("Fixed Trivial CB with bindMember")
+    {
+        // The object is bound instead of passed, and the member pointer is a
+        // template argument, so only &mid is stored
+        auto bound = bindMember<&Mid::fUnd>(mid);
+        auto boundVec = vector{ bound, bound, bound, bound, bound };
+        runBenchmark<FixedTrivialCB<int(const string&, const string&)>>(boundVec);
+    }
 }
 
 TEST_CASE("Member function lambda")
@@ -266,6 +496,10 @@ TEST_CASE("Member function lambda")
     {
         runBenchmark<DynamicCB<FT>>(memPtrs, &mid);
     }
+    SECTION("Vtable Dynamic CB")
+    {
+        runBenchmark<VtableDynamicCB<FT>>(memPtrs, &mid);
+    }
     SECTION("Big Trivial CB")
     {
         runBenchmark<BigTrivialCB<FT>>(memPtrs, &mid);
@@ -285,6 +519,14 @@ TEST_CASE("Wrapped function")
     {
         runBenchmark<FixedDynamicCB<FT>>(objVec);
     }
+    SECTION("Vtable Dynamic CB")
+    {
+        runBenchmark<VtableDynamicCB<FT>>(objVec);
+    }
+    SECTION("Fixed Vtable Dynamic CB")
+    {
+        runBenchmark<FixedVtableDynamicCB<FT>>(objVec);
+    }
     SECTION("Trivial CB")
     {
         runBenchmark<TrivialCB<FT>>(objVec);
@@ -293,9 +535,910 @@ TEST_CASE("Wrapped function")
     {
         runBenchmark<FixedTrivialCB<FT>>(objVec);
     }
+    SECTION("Closed Trivial CB")
+    {
+        runBenchmark<ClosedTrivialCB<FT, decltype(objVec)::value_type>>(objVec);
+    }
+    SECTION("Auto-selected CB")
+    {
+        runBenchmark<CallbackForT<FT, decltype(objVec)::value_type>>(objVec);
+    }
     SECTION("Std Function")
     {
         runBenchmark<StdFunction<FT>>(objVec);
     }
 }
-}
\ No newline at end of file
+
+TEST_CASE("Heap spill benchmarks")
+{
+    using FT = int(string, string);
+
+    // 64 bytes, always spills out of the 16-byte SBO buffer
+    struct Large
+    {
+        int* cnt;
+        char payload[56];
+        int operator()(const string& a, const string& b)
+        {
+            return (*cnt)++ + payload[a.size()];
+        }
+    };
+
+    int cnts[5] = { 0, 0, 5, 2, 3 };
+    vector<Large> larges;
+    for (int* cnt = cnts; cnt != cnts + 5; ++cnt) {
+        larges.push_back(Large{ cnt, {} });
+    }
+
+    SECTION("Dynamic CB with malloc")
+    {
+        runSpillBenchmark<DynamicCB<FT>>(larges, [] { return std::allocator<unsigned char>(); });
+    }
+    SECTION("Dynamic CB with monotonic arena")
+    {
+        static std::vector<std::byte> arenaBuffer(100000 * 128);
+        std::unique_ptr<std::pmr::monotonic_buffer_resource> arena;
+        runSpillBenchmark<PmrDynamicCB<FT>>(larges, [&] {
+            arena.reset();
+            arena = std::make_unique<std::pmr::monotonic_buffer_resource>(
+              arenaBuffer.data(), arenaBuffer.size(), std::pmr::null_memory_resource());
+            return std::pmr::polymorphic_allocator<unsigned char>(arena.get());
+        });
+    }
+    SECTION("Dynamic CB with unsynchronized pool")
+    {
+        std::pmr::unsynchronized_pool_resource pool;
+        runSpillBenchmark<PmrDynamicCB<FT>>(larges,
+                                            [&] { return std::pmr::polymorphic_allocator<unsigned char>(&pool); });
+    }
+}
+
+TEST_CASE("Move-only benchmarks")
+{
+    using FT = int(string, string);
+
+    auto makeUnique = [](int i) {
+        return [p = std::make_unique<int>(i)](const string& a, const string& b) { return *p + a.size(); };
+    };
+    auto makeRelocatable = [&](int i) { return assumeTriviallyRelocatable(makeUnique(i)); };
+
+    SECTION("Move-only CB")
+    {
+        runMoveOnlyBenchmark<MoveOnlyCallback<FT>>(makeUnique);
+    }
+    SECTION("Move-only CB with relocatable callable")
+    {
+        runMoveOnlyBenchmark<MoveOnlyCallback<FT>>(makeRelocatable);
+    }
+    SECTION("Relocating CB")
+    {
+        runMoveOnlyBenchmark<RelocatingCB<FT>>(makeRelocatable);
+    }
+#ifdef __cpp_lib_move_only_function
+    SECTION("Std Move Only Function")
+    {
+        runMoveOnlyBenchmark<StdMoveOnlyFunction<FT>>(makeUnique);
+    }
+#endif
+}
+
+TEST_CASE("Batch invocation benchmarks")
+{
+    using FT = int(const string&, const string&);
+    int cnts[5] = { 0, 0, 5, 2, 3 };
+
+    // 5 distinct callable types so that 5 distinct trampolines are involved
+    auto makeCB = [&](int i) {
+        int* cnt = cnts + i % 5;
+        switch (i % 5) {
+            case 0:
+                return FixedTrivialCB<FT>{ [cnt](const string& a, const string& b) { return (*cnt)++; } };
+            case 1:
+                return FixedTrivialCB<FT>{ [cnt](const string& a, const string& b) { return (*cnt)++ + 1; } };
+            case 2:
+                return FixedTrivialCB<FT>{ [cnt](const string& a, const string& b) { return (*cnt)++ + 2; } };
+            case 3:
+                return FixedTrivialCB<FT>{ [cnt](const string& a, const string& b) { return (*cnt)++ + 3; } };
+            default:
+                return FixedTrivialCB<FT>{ [cnt](const string& a, const string& b) { return (*cnt)++ + 4; } };
+        }
+    };
+
+    std::vector<int> shuffled(4000);
+    std::iota(shuffled.begin(), shuffled.end(), 0);
+    std::shuffle(shuffled.begin(), shuffled.end(), std::mt19937{ 42 });
+
+    std::vector<FixedTrivialCB<FT>> cbVec;
+    CallbackBatch<FixedTrivialCB<FT>> batch;
+    for (int idx : shuffled) {
+        cbVec.push_back(makeCB(idx));
+        batch.push_back(cbVec.back());
+    }
+    CallbackBatch<FixedTrivialCB<FT>> groupedBatch = batch;
+    groupedBatch.groupByTarget();
+
+    const string hello = "hello";
+    const string world = "world!";
+    int temp = 0;
+
+    BENCHMARK("Vector of 4000 callbacks, 250 passes")
+    {
+        for (int pass = 0; pass < 250; ++pass) {
+            for (auto& cb : cbVec) {
+                temp += cb(hello, world);
+            }
+        }
+        return temp;
+    };
+    BENCHMARK("Ungrouped batch of 4000 callbacks, 250 passes")
+    {
+        for (int pass = 0; pass < 250; ++pass) {
+            batch.invokeAll(hello, world);
+        }
+    };
+    BENCHMARK("Grouped batch of 4000 callbacks, 250 passes")
+    {
+        for (int pass = 0; pass < 250; ++pass) {
+            groupedBatch.invokeAll(hello, world);
+        }
+    };
+}
+
+TEST_CASE("Deferred work list benchmarks")
+{
+    using FT = int(const string&, const string&);
+    int cnt = 0;
+
+    // Every 4th entry captures 40 bytes, the others a single pointer
+    struct Small
+    {
+        int* cnt;
+        int operator()(const string& a, const string& b)
+        {
+            return (*cnt)++;
+        }
+    };
+    struct Big
+    {
+        int* cnt;
+        int payload[8];
+        int operator()(const string& a, const string& b)
+        {
+            return (*cnt)++ + payload[a.size() % 8];
+        }
+    };
+
+    const string hello = "hello";
+    const string world = "world!";
+    constexpr int entryCount = 1000000;
+    int temp = 0;
+
+    BENCHMARK("Vector of Dynamic CB: 1M emplaces, one pass, clear")
+    {
+        std::vector<DynamicCB<FT>> cbVec;
+        for (int i = 0; i < entryCount; ++i) {
+            if (i % 4 == 0) {
+                cbVec.emplace_back(Big{ &cnt, { i } });
+            } else {
+                cbVec.emplace_back(Small{ &cnt });
+            }
+        }
+        for (auto& cb : cbVec) {
+            temp += cb(hello, world);
+        }
+        cbVec.clear();
+        return temp;
+    };
+
+    BENCHMARK("Vector of Vtable Dynamic CB: 1M emplaces, one pass, clear")
+    {
+        std::vector<VtableDynamicCB<FT>> cbVec;
+        for (int i = 0; i < entryCount; ++i) {
+            if (i % 4 == 0) {
+                cbVec.emplace_back(Big{ &cnt, { i } });
+            } else {
+                cbVec.emplace_back(Small{ &cnt });
+            }
+        }
+        for (auto& cb : cbVec) {
+            temp += cb(hello, world);
+        }
+        cbVec.clear();
+        return temp;
+    };
+
+    BENCHMARK("Callback list: 1M emplaces, one pass, clear")
+    {
+        CallbackList<FT> cbList;
+        for (int i = 0; i < entryCount; ++i) {
+            if (i % 4 == 0) {
+                cbList.emplace(Big{ &cnt, { i } });
+            } else {
+                cbList.emplace(Small{ &cnt });
+            }
+        }
+        cbList.invokeAll(hello, world);
+        cbList.clear();
+        return temp;
+    };
+}
+}
+
+template<typename EmitFn>
+void runEmitters(int threadCount, int emitsPerThread, EmitFn emit)
+{
+    std::vector<std::thread> threads;
+    for (int i = 0; i < threadCount; ++i) {
+        threads.emplace_back([&] {
+            for (int j = 0; j < emitsPerThread; ++j) {
+                emit();
+            }
+        });
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+}
+
+TEST_CASE("Signal emit benchmarks")
+{
+    using FT = int(const string&, const string&);
+    std::atomic<int> cnt{ 0 };
+
+    // 8 slots, each capturing 40 bytes so that copying spills to the heap
+    struct Slot
+    {
+        std::atomic<int>* cnt;
+        int payload[8];
+        int operator()(const string& a, const string& b)
+        {
+            return cnt->fetch_add(payload[a.size() % 8], std::memory_order_relaxed);
+        }
+    };
+
+    std::mutex slotsMutex;
+    std::vector<DynamicCB<FT>> slots;
+    Signal<DynamicCB<FT>> signal;
+    for (int i = 0; i < 8; ++i) {
+        slots.emplace_back(Slot{ &cnt, { i } });
+        signal.connect(Slot{ &cnt, { i } });
+    }
+
+    const string hello = "hello";
+    const string world = "world!";
+    constexpr int emitsPerThread = 20000;
+
+    auto lockedCopyEmit = [&] {
+        std::vector<DynamicCB<FT>> snapshot;
+        {
+            std::lock_guard<std::mutex> lock(slotsMutex);
+            snapshot = slots;
+        }
+        for (auto& cb : snapshot) {
+            cb(hello, world);
+        }
+    };
+    auto signalEmit = [&] { signal.emit(hello, world); };
+
+    for (int threadCount : { 1, 4 }) {
+        BENCHMARK("Mutex + copied vector, " + std::to_string(threadCount) + " thread(s) x 20000 emits")
+        {
+            runEmitters(threadCount, emitsPerThread, lockedCopyEmit);
+        };
+        BENCHMARK("Signal snapshot, " + std::to_string(threadCount) + " thread(s) x 20000 emits")
+        {
+            runEmitters(threadCount, emitsPerThread, signalEmit);
+        };
+    }
+}
+
+TEST_CASE("Signal emit contention benchmarks")
+{
+    using FT = int(int);
+    constexpr int emitsPerThread = 1000000;
+
+    // Per thread, so that emitters share nothing but the slot list
+    static thread_local int sink = 0;
+    struct Slot
+    {
+        int k;
+        int operator()(int x) { return sink += x + k; }
+    };
+
+    // A slot list behind an atomic shared_ptr, as Signal published it before
+    using Snapshot = std::vector<std::shared_ptr<DynamicCB<FT>>>;
+    auto slots = std::make_shared<Snapshot>();
+    Signal<DynamicCB<FT>> signal;
+    for (int i = 0; i < 4; ++i) {
+        slots->push_back(std::make_shared<DynamicCB<FT>>(Slot{ i }));
+        signal.connect(Slot{ i });
+    }
+    std::atomic<std::shared_ptr<const Snapshot>> sharedSnapshot{ std::move(slots) };
+
+    // With as many cores as threads, flat times mean emits do not contend
+    for (int threadCount : { 1, 2, 4, 8 }) {
+        const string suffix = ", " + std::to_string(threadCount) + " thread(s) x 1M emits";
+        BENCHMARK("Atomic shared_ptr snapshot" + suffix)
+        {
+            runEmitters(threadCount, emitsPerThread, [&] {
+                const std::shared_ptr<const Snapshot> current = sharedSnapshot.load(std::memory_order_acquire);
+                for (const auto& slot : *current) {
+                    (*slot)(1);
+                }
+            });
+        };
+        BENCHMARK("Signal epoch snapshot" + suffix)
+        {
+            runEmitters(threadCount, emitsPerThread, [&] { signal.emit(1); });
+        };
+    }
+}
+
+TEST_CASE("Hot-swappable handler benchmarks")
+{
+    using FT = int(int);
+    constexpr int callsPerThread = 1000000;
+
+    // A writer replaces the handler for as long as the readers run
+    auto withSwapper = [](auto swap, auto read) {
+        std::atomic<bool> done{ false };
+        std::thread writer([&] {
+            for (int i = 0; !done.load(std::memory_order_relaxed); ++i) {
+                swap(i);
+                std::this_thread::yield();
+            }
+        });
+        read();
+        done.store(true, std::memory_order_relaxed);
+        writer.join();
+    };
+
+    // Per thread, so that readers share nothing but the handler
+    static thread_local int sink = 0;
+    std::shared_mutex handlerMutex;
+    DynamicCB<FT> lockedHandler{ [k = 0](int x) { return x + k; } };
+    AtomicCallback<FixedTrivialCB<FT>> snapshotHandler{ [k = 0](int x) { return x + k; } };
+    AtomicCallback<DynamicCB<FT>> heapHandler{ [k = 0](int x) { return x + k; } };
+
+    for (int threadCount : { 1, 4 }) {
+        const string suffix = ", " + std::to_string(threadCount) + " thread(s) x 1M calls";
+        BENCHMARK("Shared mutex + Dynamic CB" + suffix)
+        {
+            withSwapper(
+              [&](int i) {
+                  std::unique_lock<std::shared_mutex> lock(handlerMutex);
+                  lockedHandler = DynamicCB<FT>([k = i](int x) { return x + k; });
+              },
+              [&] {
+                  runEmitters(threadCount, callsPerThread, [&] {
+                      std::shared_lock<std::shared_mutex> lock(handlerMutex);
+                      sink += lockedHandler(1);
+                  });
+              });
+        };
+        BENCHMARK("Atomic snapshot of Fixed Trivial CB" + suffix)
+        {
+            withSwapper([&](int i) { snapshotHandler.store([k = i](int x) { return x + k; }); },
+                        [&] {
+                            runEmitters(threadCount, callsPerThread, [&] {
+                                sink += snapshotHandler(1);
+                            });
+                        });
+        };
+        BENCHMARK("Epoch-reclaimed Dynamic CB" + suffix)
+        {
+            withSwapper([&](int i) { heapHandler.store([k = i](int x) { return x + k; }); },
+                        [&] {
+                            runEmitters(threadCount, callsPerThread, [&] {
+                                sink += heapHandler(1);
+                            });
+                        });
+        };
+    }
+}
+
+TEST_CASE("Task queue benchmarks")
+{
+    using FT = void();
+    constexpr int producerCount = 4;
+    constexpr int tasksPerProducer = 50000;
+    constexpr int taskCount = producerCount * tasksPerProducer;
+    std::atomic<long> sum{ 0 };
+
+    // Captures 16 bytes, which spills DynamicCB's 16-byte buffer once the vptr is counted
+    auto makeTask = [&sum](int i) {
+        return [&sum, i] { sum.fetch_add(i, std::memory_order_relaxed); };
+    };
+
+    BENCHMARK("Mutex + deque of Dynamic CB, 4 producers")
+    {
+        std::mutex queueMutex;
+        std::deque<DynamicCB<FT>> queue;
+        std::vector<std::thread> producers;
+        for (int p = 0; p < producerCount; ++p) {
+            producers.emplace_back([&] {
+                for (int i = 0; i < tasksPerProducer; ++i) {
+                    std::lock_guard<std::mutex> lock(queueMutex);
+                    queue.emplace_back(makeTask(i));
+                }
+            });
+        }
+        for (int ran = 0; ran < taskCount;) {
+            std::unique_lock<std::mutex> lock(queueMutex);
+            if (queue.empty()) {
+                lock.unlock();
+                std::this_thread::yield();
+                continue;
+            }
+            DynamicCB<FT> task(std::move(queue.front()));
+            queue.pop_front();
+            lock.unlock();
+            task();
+            ++ran;
+        }
+        for (auto& t : producers) {
+            t.join();
+        }
+        return sum.load();
+    };
+
+    BENCHMARK("Lock-free task queue of 1024 Fixed Trivial CB, 4 producers")
+    {
+        TaskQueue<Callback<FT,
+                           MovePolicy::TRIVIAL_ONLY,
+                           CopyPolicy::TRIVIAL_ONLY,
+                           DestroyPolicy::TRIVIAL_ONLY,
+                           SBOPolicy::FIXED_SIZE,
+                           16>,
+                  1024>
+          queue;
+        std::vector<std::thread> producers;
+        for (int p = 0; p < producerCount; ++p) {
+            producers.emplace_back([&] {
+                for (int i = 0; i < tasksPerProducer; ++i) {
+                    queue.push(makeTask(i));
+                }
+            });
+        }
+        for (std::size_t ran = 0; ran < taskCount;) {
+            const std::size_t batch = queue.runAll();
+            if (batch == 0) {
+                std::this_thread::yield();
+            }
+            ran += batch;
+        }
+        for (auto& t : producers) {
+            t.join();
+        }
+        return sum.load();
+    };
+}
+
+// A coroutine that starts eagerly and destroys itself when done
+struct DetachedTask
+{
+    struct promise_type
+    {
+        DetachedTask get_return_object() { return {}; }
+        std::suspend_never initial_suspend() noexcept { return {}; }
+        std::suspend_never final_suspend() noexcept { return {}; }
+        void return_void() {}
+        void unhandled_exception() { std::terminate(); }
+    };
+};
+
+// Hand-rolled bridge: the completion captures the handle and where to put the result
+struct DynamicCBAwaiter
+{
+    std::function<void(DynamicCB<void(std::size_t)>)>* initiate;
+    std::size_t result = 0;
+
+    bool await_ready() const noexcept { return false; }
+    void await_suspend(std::coroutine_handle<> handle)
+    {
+        (*initiate)(DynamicCB<void(std::size_t)>{ [handle, this](std::size_t value) {
+            result = value;
+            handle.resume();
+        } });
+    }
+    std::size_t await_resume() const noexcept { return result; }
+};
+
+TEST_CASE("Coroutine bridge benchmarks")
+{
+    constexpr int awaitCount = 100000;
+    std::size_t total = 0;
+
+    using FixedCompletionCB = FixedTrivialCB<void(std::size_t)>;
+    FixedCompletionCB pendingFixed{ [](std::size_t) {} };
+    DynamicCB<void(std::size_t)> pendingDynamic{ [](std::size_t) {} };
+    bool hasPending = false;
+
+    std::function<void(DynamicCB<void(std::size_t)>)> initiateDynamic = [&](DynamicCB<void(std::size_t)> cb) {
+        pendingDynamic = std::move(cb);
+        hasPending = true;
+    };
+    auto dynamicLoop = [&]() -> DetachedTask {
+        for (int i = 0; i < awaitCount; ++i) {
+            total += co_await DynamicCBAwaiter{ &initiateDynamic };
+        }
+    };
+    auto fixedLoop = [&]() -> DetachedTask {
+        for (int i = 0; i < awaitCount; ++i) {
+            total += co_await awaitCallback<FixedCompletionCB>([&](FixedCompletionCB cb) {
+                pendingFixed = cb;
+                hasPending = true;
+            });
+        }
+    };
+
+    BENCHMARK("100000 awaits bridged through Dynamic CB")
+    {
+        dynamicLoop();
+        while (hasPending) {
+            hasPending = false;
+            auto cb = std::move(pendingDynamic);
+            cb(1);
+        }
+        return total;
+    };
+    BENCHMARK("100000 awaits bridged through awaitCallback with Fixed Trivial CB")
+    {
+        fixedLoop();
+        while (hasPending) {
+            hasPending = false;
+            auto cb = pendingFixed;
+            cb(1);
+        }
+        return total;
+    };
+}
+
+TEST_CASE("Large capture copy benchmarks")
+{
+    // An effectively immutable config blob, captured by handlers that are
+    // copied into many subscriber lists
+    struct ConfigHandler
+    {
+        std::vector<int> thresholds = std::vector<int>(64, 1);
+        std::string name = std::string(64, 'n');
+        int operator()(const string& a, const string& b) const
+        {
+            return thresholds[a.size() % 64] + name.size();
+        }
+    };
+
+    const string hello = "hello";
+    const string world = "world!";
+    int temp = 0;
+
+    auto copyIntoSubscribers = [&](auto cb) {
+        std::vector<decltype(cb)> subscribers;
+        subscribers.reserve(10000);
+        for (int i = 0; i < 10000; ++i) {
+            subscribers.push_back(cb);
+        }
+        for (auto& subscriber : subscribers) {
+            temp += subscriber(hello, world);
+        }
+        return temp;
+    };
+
+    BENCHMARK("Dynamic CB: 10000 copies and calls")
+    {
+        return copyIntoSubscribers(DynamicCB<int(const string&, const string&)>{ ConfigHandler{} });
+    };
+    BENCHMARK("Std Function: 10000 copies and calls")
+    {
+        return copyIntoSubscribers(StdFunction<int(const string&, const string&)>{ ConfigHandler{} });
+    };
+    BENCHMARK("Shared CB with const signature: 10000 copies and calls")
+    {
+        return copyIntoSubscribers(SharedCB<int(const string&, const string&) const>{ ConfigHandler{} });
+    };
+}
+
+
+TEST_CASE("Converted callback benchmarks")
+{
+    int cnts[5] = { 0, 0, 5, 2, 3 };
+    using FT = int(string, string);
+
+    // Callbacks handed down from an API layer that uses FixedTrivialCB
+    vector<FixedTrivialCB<FT>> fixedCBs;
+    for (int* cnt : { cnts, cnts + 1, cnts + 2, cnts + 3, cnts + 4 }) {
+        fixedCBs.emplace_back([cnt](const string& a, const string& b) { return (*cnt)++; });
+    }
+    SECTION("Vtable Dynamic CB adopting Fixed Trivial CB")
+    {
+        runBenchmark<VtableDynamicCB<FT>>(fixedCBs);
+    }
+    SECTION("Dynamic CB adopting Fixed Trivial CB")
+    {
+        runBenchmark<DynamicCB<FT>>(fixedCBs);
+    }
+    SECTION("Std Function wrapping Fixed Trivial CB")
+    {
+        runBenchmark<StdFunction<FT>>(fixedCBs);
+    }
+}
+
+namespace {
+template<typename VisitorT>
+int
+descend(int depth, VisitorT visit)
+{
+    if (depth == 0) {
+        return 0;
+    }
+    return visit(depth) + descend(depth - 1, visit);
+}
+} // namespace
+
+TEST_CASE("Visitor passing benchmarks")
+{
+    // A stateful visitor passed down a 32 level deep call stack
+    int sum = 0;
+    auto visitor = [&sum](int depth) { return sum += depth; };
+    using FT = int(int);
+
+    BENCHMARK("Callback Ref by value: 100000 walks")
+    {
+        for (int i = 0; i < 100000; ++i) {
+            descend<CallbackRef<FT>>(32, visitor);
+        }
+        return sum;
+    };
+    BENCHMARK("Fixed Trivial CB by value: 100000 walks")
+    {
+        for (int i = 0; i < 100000; ++i) {
+            descend<FixedTrivialCB<FT>>(32, FixedTrivialCB<FT>{ visitor });
+        }
+        return sum;
+    };
+    BENCHMARK("Dynamic CB by reference: 100000 walks")
+    {
+        for (int i = 0; i < 100000; ++i) {
+            DynamicCB<FT> cb{ visitor };
+            descend<DynamicCB<FT>&>(32, cb);
+        }
+        return sum;
+    };
+    BENCHMARK("Std Function by reference: 100000 walks")
+    {
+        for (int i = 0; i < 100000; ++i) {
+            StdFunction<FT> cb{ visitor };
+            descend<const StdFunction<FT>&>(32, cb);
+        }
+        return sum;
+    };
+}
+
+namespace {
+// Calls with scalar arguments only, so that the cost of passing them
+// through the trampoline is not hidden by string construction
+template<typename CBType, typename ObjVecT>
+long long
+runScalarBenchmark(const ObjVecT& objVec)
+{
+    std::vector<CBType> cbVec;
+    for (int i = 0; i < 400; ++i) {
+        cbVec.emplace_back(objVec[i % objVec.size()]);
+    }
+    std::vector<int> indices(1000000);
+    for (int& idx : indices) {
+        idx = std::rand() % 400;
+    }
+
+    long long temp = 0;
+    BENCHMARK("Random calls on 400 callbacks with (int, double, long)")
+    {
+        for (int idx : indices) {
+            temp += cbVec[idx](idx, 0.5, temp);
+        }
+        return temp;
+    };
+    return temp;
+}
+} // namespace
+
+TEST_CASE("Scalar signature benchmarks")
+{
+    using FT = long long(int, double, long);
+    auto objVec = vector{ +[](int a, double b, long c) -> long long { return a + (c & 7); },
+                          +[](int a, double b, long c) -> long long { return a * 2 - (c & 3); },
+                          +[](int a, double b, long c) -> long long { return (a ^ c) & 15; } };
+    SECTION("Dynamic CB")
+    {
+        runScalarBenchmark<DynamicCB<FT>>(objVec);
+    }
+    SECTION("Vtable Dynamic CB")
+    {
+        runScalarBenchmark<VtableDynamicCB<FT>>(objVec);
+    }
+    SECTION("Fixed Trivial CB")
+    {
+        runScalarBenchmark<FixedTrivialCB<FT>>(objVec);
+    }
+    SECTION("Function Ref")
+    {
+        runScalarBenchmark<FunctionRef<FT>>(objVec);
+    }
+    SECTION("Std Function")
+    {
+        runScalarBenchmark<StdFunction<FT>>(objVec);
+    }
+}
+
+TEST_CASE("Pipeline benchmarks")
+{
+    // parse -> validate -> dispatch, each stage capturing some state, run
+    // over a million messages
+    constexpr int callCount = 1000000;
+    vector<string> messages;
+    for (int i = 0; i < 64; ++i) {
+        messages.push_back(string(i % 24, 'm'));
+    }
+    vector<long long> counters(32);
+    auto parse = [offset = 3](const string& message) { return static_cast<int>(message.size()) + offset; };
+    auto validate = [limit = 20](int length) { return length < limit ? length : -1; };
+    auto dispatch = [counters = counters.data()](int length) {
+        if (length >= 0) {
+            ++counters[length];
+        }
+    };
+    auto run = [&](auto& handler) {
+        for (int i = 0; i < callCount; ++i) {
+            handler(messages[i % 64]);
+        }
+        return counters[5];
+    };
+
+    BENCHMARK("Nested Dynamic CB wrapping lambdas")
+    {
+        DynamicCB<void(int)> dispatchStage{ dispatch };
+        DynamicCB<void(int)> validateStage{ [validate, next = std::move(dispatchStage)](int length) mutable {
+            next(validate(length));
+        } };
+        DynamicCB<void(const string&)> handler{ [parse, next = std::move(validateStage)](
+                                                  const string& message) mutable { next(parse(message)); } };
+        return run(handler);
+    };
+    BENCHMARK("Nested Dynamic CB wrapping Dynamic CBs")
+    {
+        DynamicCB<int(const string&)> parseStage{ parse };
+        DynamicCB<int(int)> validateStage{ validate };
+        DynamicCB<void(int)> dispatchStage{ dispatch };
+        DynamicCB<void(int)> tail{ [validateStage = std::move(validateStage),
+                                    dispatchStage = std::move(dispatchStage)](int length) mutable {
+            dispatchStage(validateStage(length));
+        } };
+        DynamicCB<void(const string&)> handler{ [parseStage = std::move(parseStage), tail = std::move(tail)](
+                                                  const string& message) mutable { tail(parseStage(message)); } };
+        return run(handler);
+    };
+    BENCHMARK("Dynamic CB of composed Dynamic CBs")
+    {
+        DynamicCB<void(const string&)> handler{ compose(
+          DynamicCB<int(const string&)>{ parse }, DynamicCB<int(int)>{ validate }, DynamicCB<void(int)>{ dispatch }) };
+        return run(handler);
+    };
+    BENCHMARK("Dynamic CB of composed lambdas")
+    {
+        DynamicCB<void(const string&)> handler{ compose(parse, validate, dispatch) };
+        return run(handler);
+    };
+    BENCHMARK("makeCallback of composed lambdas")
+    {
+        auto handler = makeCallback<void(const string&)>(compose(parse, validate, dispatch));
+        return run(handler);
+    };
+}
+
+TEST_CASE("Empty slot table benchmarks")
+{
+    // A million slots created, grown to twice that and torn down, empty
+    // except for every 64th one
+    constexpr int slotCount = 1000000;
+    using FT = int(int);
+    auto placeholder = [](int) { return 0; };
+    auto handler = [](int x) { return x + 1; };
+
+    BENCHMARK("Vtable Dynamic CB slots holding a placeholder lambda")
+    {
+        vector<VtableDynamicCB<FT>> slots(slotCount, VtableDynamicCB<FT>{ placeholder });
+        for (int i = 0; i < slotCount; i += 64) {
+            slots[i] = VtableDynamicCB<FT>{ handler };
+        }
+        slots.resize(2 * slotCount, VtableDynamicCB<FT>{ placeholder });
+        return slots[64](1);
+    };
+    BENCHMARK("Empty Vtable Dynamic CB slots")
+    {
+        vector<VtableDynamicCB<FT>> slots(slotCount);
+        for (int i = 0; i < slotCount; i += 64) {
+            slots[i] = VtableDynamicCB<FT>{ handler };
+        }
+        slots.resize(2 * slotCount);
+        return slots[64](1);
+    };
+    BENCHMARK("Dynamic CB slots holding a placeholder lambda")
+    {
+        vector<DynamicCB<FT>> slots(slotCount, DynamicCB<FT>{ placeholder });
+        for (int i = 0; i < slotCount; i += 64) {
+            slots[i] = DynamicCB<FT>{ handler };
+        }
+        slots.resize(2 * slotCount, DynamicCB<FT>{ placeholder });
+        return slots[64](1);
+    };
+    BENCHMARK("Empty Dynamic CB slots")
+    {
+        vector<DynamicCB<FT>> slots(slotCount);
+        for (int i = 0; i < slotCount; i += 64) {
+            slots[i] = DynamicCB<FT>{ handler };
+        }
+        slots.resize(2 * slotCount);
+        return slots[64](1);
+    };
+}
+
+TEST_CASE("Timer benchmarks")
+{
+    // A million timers due within 2^20 ticks, each bumping a counter of one
+    // of 1024 sessions; every 4th one is cancelled before it fires
+    constexpr int timerCount = 1000000;
+    constexpr std::uint64_t horizon = 1 << 20;
+    struct Session
+    {
+        long long expirations = 0;
+    };
+    std::vector<Session> sessions(1024);
+    std::vector<std::uint64_t> deadlines(timerCount);
+    std::mt19937_64 rng(42);
+    for (std::uint64_t& deadline : deadlines) {
+        deadline = 1 + rng() % horizon;
+    }
+    auto makeTimer = [&sessions](int i) { return [session = &sessions[i % 1024]] { ++session->expirations; }; };
+
+    BENCHMARK("Priority queue of Std Function: 1M timers, 1/4 cancelled")
+    {
+        struct Timer
+        {
+            std::uint64_t when;
+            int id;
+            StdFunction<void()> callback;
+        };
+        auto later = [](const Timer& a, const Timer& b) { return a.when > b.when; };
+        std::priority_queue<Timer, std::vector<Timer>, decltype(later)> queue(later);
+        // A heap cannot unlink an entry: cancelled ones are skipped when due
+        std::vector<char> cancelled(timerCount);
+        for (int i = 0; i < timerCount; ++i) {
+            queue.push(Timer{ deadlines[i], i, makeTimer(i) });
+            if (i % 4 == 3) {
+                cancelled[i - 2] = 1;
+            }
+        }
+        while (!queue.empty()) {
+            if (!cancelled[queue.top().id]) {
+                queue.top().callback();
+            }
+            queue.pop();
+        }
+        return sessions[0].expirations;
+    };
+
+    BENCHMARK("Timer wheel of Fixed Trivial CB: 1M timers, 1/4 cancelled")
+    {
+        using Wheel = TimerWheel<FixedTrivialCB<void()>>;
+        Wheel wheel;
+        std::vector<Wheel::TimerId> ids(timerCount);
+        for (int i = 0; i < timerCount; ++i) {
+            ids[i] = wheel.scheduleAt(deadlines[i], makeTimer(i));
+            if (i % 4 == 3) {
+                wheel.cancel(ids[i - 2]);
+            }
+        }
+        wheel.advance(horizon);
+        return sessions[0].expirations;
+    };
+}
@@ -0,0 +1,238 @@
+// Compile-time cost of PolicyCB.hpp: the cost of including it, and the time
+// and memory each Callback instantiation adds, for several signatures and
+// policies. Each case is a generated translation unit wrapping N distinct
+// lambdas in one Callback type; it is compiled with 0 and N lambdas and the
+// difference is divided by N. Peak RSS is the compiler's, from wait4().
+//
+// Usage: compile_time [--cxx g++] [--include dir] [--count 100] [--json out.json]
+// The compiler and include directory default to the ones CMake configured.
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+#ifndef POLICYCB_CXX_COMPILER
+#define POLICYCB_CXX_COMPILER "c++"
+#endif
+#ifndef POLICYCB_INCLUDE_DIR
+#define POLICYCB_INCLUDE_DIR "include"
+#endif
+
+namespace {
+
+constexpr int repetitions = 3;
+
+struct Signature
+{
+    const char* name;
+    const char* type;
+    const char* params;
+    // Between the parameters and the body of the lambdas
+    const char* specifiers;
+    // Uses the parameters, the capture k and the lambda index I
+    const char* body;
+};
+
+constexpr Signature signatures[] = {
+    { "void()", "void()", "", "", "{ (void)(k + I); }" },
+    { "int(int)", "int(int)", "int a", "", "{ return a + k + I; }" },
+    { "long(int, double, const char*)",
+      "long(int, double, const char*)",
+      "int a, double b, const char* c",
+      "",
+      "{ return a + static_cast<long>(b) + c[0] + k + I; }" },
+    { "int(int) const noexcept", "int(int) const noexcept", "int a", "noexcept", "{ return a + k + I; }" },
+};
+
+struct Policy
+{
+    const char* name;
+    // Callback type with FT as the signature
+    const char* callback;
+    // Whether the lambdas may capture
+    bool capture;
+};
+
+constexpr Policy policies[] = {
+    { "VIRTCALL (DYNAMIC_GROWTH)",
+      "Callback<FT, MovePolicy::DYNAMIC, CopyPolicy::DYNAMIC, DestroyPolicy::DYNAMIC, SBOPolicy::DYNAMIC_GROWTH>",
+      true },
+    { "STATIC_VTABLE (DYNAMIC_GROWTH)",
+      "Callback<FT, MovePolicy::DYNAMIC, CopyPolicy::DYNAMIC, DestroyPolicy::DYNAMIC, SBOPolicy::DYNAMIC_GROWTH, 16, "
+      "std::allocator<unsigned char>, DispatchPolicy::STATIC_VTABLE>",
+      true },
+    { "MoveOnlyCallback", "MoveOnlyCallback<FT>", true },
+    { "FUNC_PTR (FIXED_SIZE)",
+      "Callback<FT, MovePolicy::TRIVIAL_ONLY, CopyPolicy::TRIVIAL_ONLY, DestroyPolicy::TRIVIAL_ONLY, "
+      "SBOPolicy::FIXED_SIZE, 8>",
+      true },
+    { "NO_DISPATCH (NO_STORAGE)",
+      "Callback<FT, MovePolicy::TRIVIAL_ONLY, CopyPolicy::TRIVIAL_ONLY, DestroyPolicy::TRIVIAL_ONLY, "
+      "SBOPolicy::NO_STORAGE, 0>",
+      false },
+};
+
+struct Measurement
+{
+    double ms;
+    long maxRssKb;
+};
+
+struct Options
+{
+    std::string cxx = POLICYCB_CXX_COMPILER;
+    std::string includeDir = POLICYCB_INCLUDE_DIR;
+    std::string workDir;
+    int count = 100;
+};
+
+std::string
+generate(bool includeHeader, const Signature* signature, const Policy* policy, int lambdas)
+{
+    std::ostringstream out;
+    if (includeHeader) {
+        out << "#include \"PolicyCB.hpp\"\nusing namespace PolicyCB;\n";
+    }
+    if (!signature) {
+        return out.str();
+    }
+    out << "using FT = " << signature->type << ";\nusing CB = " << policy->callback << ";\n"
+        << "void consume(CB&&);\nvoid instantiate()\n{\n";
+    for (int i = 0; i < lambdas; ++i) {
+        out << "    {\n        constexpr int I = " << i << ";\n";
+        if (policy->capture) {
+            out << "        consume(CB{ [k = " << i << "](" << signature->params << ") " << signature->specifiers << " "
+                << signature->body << " });\n";
+        } else {
+            out << "        consume(CB{ [](" << signature->params << ") " << signature->specifiers
+                << " { constexpr int k = 0; " << signature->body + 1 << " });\n";
+        }
+        out << "    }\n";
+    }
+    out << "}\n";
+    return out.str();
+}
+
+#if defined(__unix__) || defined(__APPLE__)
+// Compiles source to an object file and returns the fastest of a few runs
+Measurement
+compile(const Options& options, const std::string& source)
+{
+    const std::string sourcePath = options.workDir + "/tu.cpp";
+    const std::string objectPath = options.workDir + "/tu.o";
+    std::ofstream(sourcePath) << source;
+
+    const std::string includeFlag = "-I" + options.includeDir;
+    std::vector<const char*> argv{ options.cxx.c_str(), "-std=c++20", "-O2",       includeFlag.c_str(),
+                                   "-c",                sourcePath.c_str(), "-o", objectPath.c_str(),
+                                   nullptr };
+
+    Measurement best{ 0, 0 };
+    for (int run = 0; run < repetitions; ++run) {
+        const auto begin = std::chrono::steady_clock::now();
+        const pid_t pid = fork();
+        if (pid == 0) {
+            execvp(argv[0], const_cast<char* const*>(argv.data()));
+            _exit(127);
+        }
+        int status = 0;
+        rusage usage{};
+        wait4(pid, &status, 0, &usage);
+        const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count();
+        if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+            std::fprintf(stderr, "Compiling %s failed\n", sourcePath.c_str());
+            std::exit(1);
+        }
+        if (run == 0 || ms < best.ms) {
+            best.ms = ms;
+        }
+        best.maxRssKb = std::max(best.maxRssKb, static_cast<long>(usage.ru_maxrss));
+    }
+    return best;
+}
+#endif
+
+} // namespace
+
+int
+main(int argc, char** argv)
+{
+#if defined(__unix__) || defined(__APPLE__)
+    Options options;
+    std::string jsonPath;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        const std::string flag = argv[i];
+        if (flag == "--cxx") {
+            options.cxx = argv[i + 1];
+        } else if (flag == "--include") {
+            options.includeDir = argv[i + 1];
+        } else if (flag == "--count") {
+            options.count = std::atoi(argv[i + 1]);
+        } else if (flag == "--json") {
+            jsonPath = argv[i + 1];
+        }
+    }
+    char workDir[] = "/tmp/policycb_compile_timeXXXXXX";
+    if (!mkdtemp(workDir)) {
+        std::perror("mkdtemp");
+        return 1;
+    }
+    options.workDir = workDir;
+
+    const Measurement empty = compile(options, generate(false, nullptr, nullptr, 0));
+    const Measurement header = compile(options, generate(true, nullptr, nullptr, 0));
+    std::fprintf(stderr,
+                 "include PolicyCB.hpp: %.1f ms, %ld KB\n",
+                 header.ms - empty.ms,
+                 header.maxRssKb - empty.maxRssKb);
+
+    std::ostringstream json;
+    json << "{\n  \"compiler\": \"" << options.cxx << "\",\n  \"lambdas_per_case\": " << options.count
+         << ",\n  \"include_ms\": " << header.ms - empty.ms
+         << ",\n  \"include_rss_kb\": " << header.maxRssKb - empty.maxRssKb << ",\n  \"results\": [\n";
+    bool first = true;
+    for (const Policy& policy : policies) {
+        for (const Signature& signature : signatures) {
+            const Measurement base = compile(options, generate(true, &signature, &policy, 0));
+            const Measurement full = compile(options, generate(true, &signature, &policy, options.count));
+            const double msPerInstantiation = (full.ms - base.ms) / options.count;
+            const double kbPerInstantiation = static_cast<double>(full.maxRssKb - base.maxRssKb) / options.count;
+            std::fprintf(stderr,
+                         "%-32s %-32s %8.3f ms %8.1f KB per instantiation\n",
+                         policy.name,
+                         signature.name,
+                         msPerInstantiation,
+                         kbPerInstantiation);
+            json << (first ? "" : ",\n") << "    {\"policy\": \"" << policy.name << "\", \"signature\": \""
+                 << signature.name << "\", \"ms_per_instantiation\": " << msPerInstantiation
+                 << ", \"rss_kb_per_instantiation\": " << kbPerInstantiation << "}";
+            first = false;
+        }
+    }
+    json << "\n  ]\n}\n";
+
+    std::remove((options.workDir + "/tu.cpp").c_str());
+    std::remove((options.workDir + "/tu.o").c_str());
+    rmdir(workDir);
+
+    if (jsonPath.empty()) {
+        std::fputs(json.str().c_str(), stdout);
+    } else {
+        std::ofstream(jsonPath) << json.str();
+    }
+    return 0;
+#else
+    std::fprintf(stderr, "compile_time needs fork() and wait4()\n");
+    return 1;
+#endif
+}
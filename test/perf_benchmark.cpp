@@ -0,0 +1,526 @@
+// Per-call cost of each dispatch method and SBO policy, measured with
+// hardware counters where perf_event_open is available and wall time
+// otherwise. Call sequences are generated up front and calls only take
+// scalars, so the numbers are dominated by dispatch.
+//
+// Usage: perf_benchmark [--json out.json] [--baseline old.json] [--tolerance 0.05]
+// With --baseline, exits with 1 if any case got slower by more than the
+// tolerance, comparing cycles per call (ns per call without counters), and
+// with 2 if the baseline cannot gate this run: it is missing or unreadable,
+// was measured with the other metric, or lacks one of the cases.
+#include "PolicyCB.hpp"
+#include "PolicyCB/LatencyProbe.hpp"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <map>
+#include <optional>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+using namespace PolicyCB;
+
+namespace {
+
+using FT = long long(int);
+
+template<SBOPolicy SBOP, std::size_t Size = 16>
+using DynamicCB = Callback<FT, MovePolicy::DYNAMIC, CopyPolicy::DYNAMIC, DestroyPolicy::DYNAMIC, SBOP, Size>;
+template<SBOPolicy SBOP, std::size_t Size = 16>
+using VtableDynamicCB = Callback<FT,
+                                 MovePolicy::DYNAMIC,
+                                 CopyPolicy::DYNAMIC,
+                                 DestroyPolicy::DYNAMIC,
+                                 SBOP,
+                                 Size,
+                                 std::allocator<unsigned char>,
+                                 DispatchPolicy::STATIC_VTABLE>;
+template<typename InvokeProbe>
+using ProbedDynamicCB = Callback<FT,
+                                 MovePolicy::DYNAMIC,
+                                 CopyPolicy::DYNAMIC,
+                                 DestroyPolicy::DYNAMIC,
+                                 SBOPolicy::FIXED_SIZE,
+                                 16,
+                                 std::allocator<unsigned char>,
+                                 DispatchPolicy::AUTO,
+                                 InvokeProbe>;
+template<SBOPolicy SBOP, std::size_t Size = 16>
+using TrivialCB =
+  Callback<FT, MovePolicy::TRIVIAL_ONLY, CopyPolicy::TRIVIAL_ONLY, DestroyPolicy::TRIVIAL_ONLY, SBOP, Size>;
+
+enum Counter
+{
+    CYCLES,
+    INSTRUCTIONS,
+    BRANCH_MISSES,
+    L1D_MISSES,
+    COUNTER_COUNT,
+};
+
+constexpr std::array<const char*, COUNTER_COUNT> counterNames{
+    "cycles", "instructions", "branch_misses", "l1d_misses"
+};
+
+// One perf event per counter, each opened on its own so that a counter the
+// machine lacks does not take the others down. Counters that could not be
+// opened read as nullopt.
+class PerfCounters
+{
+    std::array<int, COUNTER_COUNT> fds;
+
+#if defined(__linux__)
+    static int open(std::uint32_t type, std::uint64_t config)
+    {
+        perf_event_attr attr;
+        memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = type;
+        attr.config = config;
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+    }
+#endif
+
+  public:
+    PerfCounters()
+    {
+        fds.fill(-1);
+#if defined(__linux__)
+        fds[CYCLES] = open(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES);
+        fds[INSTRUCTIONS] = open(PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS);
+        fds[BRANCH_MISSES] = open(PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES);
+        fds[L1D_MISSES] = open(PERF_TYPE_HW_CACHE,
+                               PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                                 (PERF_COUNT_HW_CACHE_RESULT_MISS << 16));
+#endif
+    }
+
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+
+    ~PerfCounters()
+    {
+#if defined(__linux__)
+        for (int fd : fds) {
+            if (fd >= 0) {
+                close(fd);
+            }
+        }
+#endif
+    }
+
+    bool anyAvailable() const noexcept
+    {
+        return std::any_of(fds.begin(), fds.end(), [](int fd) { return fd >= 0; });
+    }
+
+    void start() noexcept
+    {
+#if defined(__linux__)
+        for (int fd : fds) {
+            if (fd >= 0) {
+                ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+                ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+            }
+        }
+#endif
+    }
+
+    std::array<std::optional<std::uint64_t>, COUNTER_COUNT> stop() noexcept
+    {
+        std::array<std::optional<std::uint64_t>, COUNTER_COUNT> values;
+#if defined(__linux__)
+        for (std::size_t i = 0; i < COUNTER_COUNT; ++i) {
+            if (fds[i] >= 0) {
+                ioctl(fds[i], PERF_EVENT_IOC_DISABLE, 0);
+                std::uint64_t value;
+                if (read(fds[i], &value, sizeof(value)) == sizeof(value)) {
+                    values[i] = value;
+                }
+            }
+        }
+#endif
+        return values;
+    }
+};
+
+struct Result
+{
+    std::string name;
+    double nsPerCall;
+    std::array<std::optional<double>, COUNTER_COUNT> perCall;
+};
+
+constexpr int callbackCount = 256;
+constexpr int callsPerRun = 1 << 20;
+constexpr int runs = 7;
+
+long long
+fn0(int x)
+{
+    return x + 1;
+}
+long long
+fn1(int x)
+{
+    return x * 3;
+}
+long long
+fn2(int x)
+{
+    return x ^ 0x55;
+}
+long long
+fn3(int x)
+{
+    return x - 7;
+}
+constexpr std::array<long long (*)(int), 4> functions{ fn0, fn1, fn2, fn3 };
+
+// Four distinct callable types with an 8 byte capture
+template<int I>
+struct Small
+{
+    long long k;
+    long long operator()(int x) const
+    {
+        return functions[I](x) + k;
+    }
+};
+
+// Spills from a 16 byte buffer
+template<int I>
+struct Large
+{
+    long long k[5];
+    long long operator()(int x) const
+    {
+        return functions[I](x) + k[x & 3];
+    }
+};
+
+class Harness
+{
+    PerfCounters counters;
+    std::vector<int> indices;
+    std::vector<Result> results;
+
+  public:
+    Harness()
+      : indices(callsPerRun)
+    {
+        std::mt19937 rng(42);
+        std::uniform_int_distribution<int> dist(0, callbackCount - 1);
+        for (int& idx : indices) {
+            idx = dist(rng);
+        }
+    }
+
+    bool countersAvailable() const noexcept
+    {
+        return counters.anyAvailable();
+    }
+
+    // Calls callbacks[idx](idx) for every pregenerated idx and keeps the
+    // fastest of several runs
+    template<typename CallbackVecT>
+    void measure(const std::string& name, CallbackVecT& callbacks)
+    {
+        Result best{ name, 0, {} };
+        long long sink = 0;
+        for (int run = 0; run < runs; ++run) {
+            const auto begin = std::chrono::steady_clock::now();
+            counters.start();
+            for (int idx : indices) {
+                sink += callbacks[idx](idx);
+            }
+            const auto values = counters.stop();
+            const auto end = std::chrono::steady_clock::now();
+
+            const double ns = std::chrono::duration<double, std::nano>(end - begin).count() / callsPerRun;
+            if (run == 0 || ns < best.nsPerCall) {
+                best.nsPerCall = ns;
+                for (std::size_t i = 0; i < COUNTER_COUNT; ++i) {
+                    best.perCall[i].reset();
+                    if (values[i]) {
+                        best.perCall[i] = static_cast<double>(*values[i]) / callsPerRun;
+                    }
+                }
+            }
+        }
+        // Keeps the calls from being optimized out
+        if (sink == 42) {
+            std::fputs("", stderr);
+        }
+        results.push_back(std::move(best));
+    }
+
+    // Fills callbackCount callbacks of type CallbackT, cycling through the
+    // four callable types of Obj
+    template<typename CallbackT, template<int> typename Obj>
+    void measureCallables(const std::string& name)
+    {
+        std::vector<CallbackT> callbacks;
+        callbacks.reserve(callbackCount);
+        for (int i = 0; i < callbackCount; ++i) {
+            switch (i % 4) {
+                case 0:
+                    callbacks.emplace_back(Obj<0>{ i });
+                    break;
+                case 1:
+                    callbacks.emplace_back(Obj<1>{ i });
+                    break;
+                case 2:
+                    callbacks.emplace_back(Obj<2>{ i });
+                    break;
+                default:
+                    callbacks.emplace_back(Obj<3>{ i });
+                    break;
+            }
+        }
+        measure(name, callbacks);
+    }
+
+    template<typename CallbackT>
+    void measureFunctions(const std::string& name)
+    {
+        std::vector<CallbackT> callbacks;
+        callbacks.reserve(callbackCount);
+        for (int i = 0; i < callbackCount; ++i) {
+            callbacks.emplace_back(functions[i % 4]);
+        }
+        measure(name, callbacks);
+    }
+
+    const std::vector<Result>& getResults() const noexcept
+    {
+        return results;
+    }
+};
+
+// One result per line, so that --baseline can read it back without a JSON
+// library
+std::string
+toJson(const std::vector<Result>& results, bool countersAvailable)
+{
+    std::ostringstream out;
+    out << "{\n  \"counters_available\": " << (countersAvailable ? "true" : "false")
+        << ",\n  \"calls_per_run\": " << callsPerRun << ",\n  \"results\": [\n";
+    for (std::size_t i = 0; i < results.size(); ++i) {
+        const Result& result = results[i];
+        out << "    {\"name\": \"" << result.name << "\", \"ns_per_call\": " << result.nsPerCall;
+        for (std::size_t c = 0; c < COUNTER_COUNT; ++c) {
+            out << ", \"" << counterNames[c] << "_per_call\": ";
+            if (result.perCall[c]) {
+                out << *result.perCall[c];
+            } else {
+                out << "null";
+            }
+        }
+        out << (i + 1 == results.size() ? "}\n" : "},\n");
+    }
+    out << "  ]\n}\n";
+    return out.str();
+}
+
+std::optional<double>
+readNumber(const std::string& line, const std::string& key)
+{
+    const std::string quotedKey = "\"" + key + "\": ";
+    const std::size_t pos = line.find(quotedKey);
+    if (pos == std::string::npos || line.compare(pos + quotedKey.size(), 4, "null") == 0) {
+        return std::nullopt;
+    }
+    return std::stod(line.substr(pos + quotedKey.size()));
+}
+
+struct Baseline
+{
+    bool readable = false;
+    // Whether the baseline run had hardware counters, i.e. its metric
+    std::optional<bool> countersAvailable;
+    // Name to cycles (or ns) per call
+    std::map<std::string, double> perCall;
+};
+
+// Reads a file written by toJson()
+Baseline
+readBaseline(const std::string& path, const std::string& metric)
+{
+    Baseline baseline;
+    std::ifstream in(path);
+    baseline.readable = static_cast<bool>(in);
+    std::string line;
+    while (std::getline(in, line)) {
+        if (line.find("\"counters_available\": ") != std::string::npos) {
+            baseline.countersAvailable = line.find("true") != std::string::npos;
+            continue;
+        }
+        const std::size_t nameBegin = line.find("\"name\": \"");
+        if (nameBegin == std::string::npos) {
+            continue;
+        }
+        const std::size_t valueBegin = nameBegin + std::strlen("\"name\": \"");
+        const std::string name = line.substr(valueBegin, line.find('"', valueBegin) - valueBegin);
+        if (auto value = readNumber(line, metric)) {
+            baseline.perCall[name] = *value;
+        }
+    }
+    return baseline;
+}
+
+} // namespace
+
+int
+main(int argc, char** argv)
+{
+    std::string jsonPath;
+    std::string baselinePath;
+    double tolerance = 0.05;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        const std::string flag = argv[i];
+        if (flag == "--json") {
+            jsonPath = argv[i + 1];
+        } else if (flag == "--baseline") {
+            baselinePath = argv[i + 1];
+        } else if (flag == "--tolerance") {
+            tolerance = std::stod(argv[i + 1]);
+        }
+    }
+
+    Harness harness;
+    if (!harness.countersAvailable()) {
+        std::fprintf(stderr, "perf_event_open unavailable, reporting wall time only\n");
+    }
+
+    harness.measureFunctions<long long (*)(int)>("Raw function pointer");
+    harness.measureFunctions<TrivialCB<SBOPolicy::NO_STORAGE, 0>>("NO_DISPATCH (NO_STORAGE)");
+    harness.measureCallables<TrivialCB<SBOPolicy::FIXED_SIZE, 8>, Small>("FUNC_PTR (FIXED_SIZE)");
+    harness.measureCallables<TrivialCB<SBOPolicy::DYNAMIC_GROWTH>, Small>("FUNC_PTR (DYNAMIC_GROWTH)");
+    harness.measureCallables<TrivialCB<SBOPolicy::DYNAMIC_GROWTH>, Large>("FUNC_PTR (DYNAMIC_GROWTH, spilled)");
+    harness.measureCallables<DynamicCB<SBOPolicy::FIXED_SIZE>, Small>("VIRTCALL (FIXED_SIZE)");
+    harness.measureCallables<DynamicCB<SBOPolicy::DYNAMIC_GROWTH>, Small>("VIRTCALL (DYNAMIC_GROWTH)");
+    harness.measureCallables<DynamicCB<SBOPolicy::DYNAMIC_GROWTH>, Large>("VIRTCALL (DYNAMIC_GROWTH, spilled)");
+    harness.measureCallables<DynamicCB<SBOPolicy::SHARED_GROWTH>, Large>("VIRTCALL (SHARED_GROWTH, spilled)");
+    harness.measureCallables<ProbedDynamicCB<LatencyProbe<>>, Small>("VIRTCALL (FIXED_SIZE, LatencyProbe)");
+    harness.measureCallables<ProbedDynamicCB<LatencyProbe<void, 64>>, Small>(
+      "VIRTCALL (FIXED_SIZE, LatencyProbe 1/64)");
+    harness.measureCallables<VtableDynamicCB<SBOPolicy::FIXED_SIZE>, Small>("STATIC_VTABLE (FIXED_SIZE)");
+    harness.measureCallables<VtableDynamicCB<SBOPolicy::DYNAMIC_GROWTH>, Large>(
+      "STATIC_VTABLE (DYNAMIC_GROWTH, spilled)");
+    harness.measureCallables<std::function<FT>, Small>("std::function");
+    harness.measureCallables<std::function<FT>, Large>("std::function (spilled)");
+#ifdef __cpp_lib_move_only_function
+    harness.measureCallables<std::move_only_function<FT>, Small>("std::move_only_function");
+#else
+    std::fprintf(stderr, "std::move_only_function needs C++23, not measured\n");
+#endif
+
+    {
+        // REFERENCE Callbacks need the callables to outlive them
+        std::vector<Small<0>> referents0(callbackCount, Small<0>{ 0 });
+        std::vector<Small<1>> referents1(callbackCount, Small<1>{ 1 });
+        std::vector<Small<2>> referents2(callbackCount, Small<2>{ 2 });
+        std::vector<Small<3>> referents3(callbackCount, Small<3>{ 3 });
+        std::vector<CallbackRef<FT>> callbacks;
+        for (int i = 0; i < callbackCount; i += 4) {
+            callbacks.emplace_back(referents0[i]);
+            callbacks.emplace_back(referents1[i + 1]);
+            callbacks.emplace_back(referents2[i + 2]);
+            callbacks.emplace_back(referents3[i + 3]);
+        }
+        harness.measure("FUNC_PTR (REFERENCE)", callbacks);
+    }
+
+    const std::vector<Result>& results = harness.getResults();
+    std::fprintf(stderr, "%-42s %10s", "case", "ns/call");
+    for (const char* name : counterNames) {
+        std::fprintf(stderr, " %14s", name);
+    }
+    std::fprintf(stderr, "\n");
+    for (const Result& result : results) {
+        std::fprintf(stderr, "%-42s %10.3f", result.name.c_str(), result.nsPerCall);
+        for (const auto& value : result.perCall) {
+            if (value) {
+                std::fprintf(stderr, " %14.3f", *value);
+            } else {
+                std::fprintf(stderr, " %14s", "-");
+            }
+        }
+        std::fprintf(stderr, "\n");
+    }
+
+    const std::string json = toJson(results, harness.countersAvailable());
+    if (jsonPath.empty()) {
+        std::fputs(json.c_str(), stdout);
+    } else {
+        std::ofstream(jsonPath) << json;
+    }
+
+    if (baselinePath.empty()) {
+        return 0;
+    }
+    const bool cycles = results.front().perCall[CYCLES].has_value();
+    const std::string metric = cycles ? "cycles_per_call" : "ns_per_call";
+    const Baseline baseline = readBaseline(baselinePath, metric);
+    if (!baseline.readable) {
+        std::fprintf(stderr, "BASELINE %s cannot be read\n", baselinePath.c_str());
+        return 2;
+    }
+    if (baseline.countersAvailable != cycles) {
+        std::fprintf(stderr,
+                     "BASELINE %s was not measured in %s, as this run is\n",
+                     baselinePath.c_str(),
+                     metric.c_str());
+        return 2;
+    }
+    if (baseline.perCall.empty()) {
+        std::fprintf(stderr, "BASELINE %s has no %s results\n", baselinePath.c_str(), metric.c_str());
+        return 2;
+    }
+    bool regressed = false;
+    bool uncovered = false;
+    std::size_t compared = 0;
+    for (const Result& result : results) {
+        const auto it = baseline.perCall.find(result.name);
+        if (it == baseline.perCall.end()) {
+            std::fprintf(stderr, "NO BASELINE %s\n", result.name.c_str());
+            uncovered = true;
+            continue;
+        }
+        ++compared;
+        const double current = result.perCall[CYCLES] ? *result.perCall[CYCLES] : result.nsPerCall;
+        if (current > it->second * (1 + tolerance)) {
+            std::fprintf(stderr,
+                         "REGRESSION %s: %s %.3f -> %.3f\n",
+                         result.name.c_str(),
+                         metric.c_str(),
+                         it->second,
+                         current);
+            regressed = true;
+        }
+    }
+    std::fprintf(stderr, "Compared %zu of %zu cases against %s\n", compared, results.size(), baselinePath.c_str());
+    if (regressed) {
+        return 1;
+    }
+    return uncovered ? 2 : 0;
+}
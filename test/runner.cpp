@@ -1,7 +1,27 @@
 
 #include "PolicyCB.hpp"
+#include "PolicyCB/AtomicCallback.hpp"
+#include "PolicyCB/CallbackBatch.hpp"
+#include "PolicyCB/CallbackFor.hpp"
+#include "PolicyCB/CallbackList.hpp"
+#include "PolicyCB/ClosedCallback.hpp"
+#include "PolicyCB/Compose.hpp"
+#include "PolicyCB/Coroutine.hpp"
+#include "PolicyCB/LatencyProbe.hpp"
+#include "PolicyCB/Pmr.hpp"
+#include "PolicyCB/Signal.hpp"
+#include "PolicyCB/TaskQueue.hpp"
+#include "PolicyCB/TimerWheel.hpp"
+#include <array>
+#include <atomic>
 #include <iostream>
+#include <map>
+#include <memory>
+#include <memory_resource>
+#include <stdexcept>
 #include <string>
+#include <thread>
+#include <vector>
 using namespace PolicyCB;
 using namespace std;
 // Roughly equivalent to std::function<int(string, string)>
@@ -20,6 +40,32 @@ using FixedDynamicCB = Callback<int(string, string),
                                 SBOPolicy::FIXED_SIZE,
                                 16>;
 
+// DynamicCB that dispatches copy/move/destroy through a static table
+// per callable instead of a vptr stored in the buffer
+// 40 bytes
+using VtableDynamicCB = Callback<int(string, string),
+                                 MovePolicy::DYNAMIC,
+                                 CopyPolicy::DYNAMIC,
+                                 DestroyPolicy::DYNAMIC,
+                                 SBOPolicy::DYNAMIC_GROWTH,
+                                 16,
+                                 std::allocator<unsigned char>,
+                                 DispatchPolicy::STATIC_VTABLE>;
+
+// The std::move_only_function equivalent, 40 bytes
+using MoveOnlyCB = MoveOnlyCallback<int(string, string)>;
+
+// Moves are a memcpy of the buffer and never destroy the source.
+// Only accepts trivially relocatable invocables
+using RelocatingCB = Callback<int(string, string),
+                              MovePolicy::TRIVIAL_RELOCATION,
+                              CopyPolicy::NOCOPY,
+                              DestroyPolicy::DYNAMIC,
+                              SBOPolicy::DYNAMIC_GROWTH,
+                              16,
+                              std::allocator<unsigned char>,
+                              DispatchPolicy::STATIC_VTABLE>;
+
 // Only allows trivially-copyable invocables to optimize
 // calls. Faster to call than the above variant at the cost
 // of slightly more memory.
@@ -50,6 +96,52 @@ using FunctionRef = Callback<int(string, string),
                              SBOPolicy::NO_STORAGE,
                              0>;
 
+// A callback-based async API, completed later by runPendingCompletions()
+using SizeCompletionCB = Callback<void(size_t),
+                                  MovePolicy::TRIVIAL_ONLY,
+                                  CopyPolicy::TRIVIAL_ONLY,
+                                  DestroyPolicy::TRIVIAL_ONLY,
+                                  SBOPolicy::FIXED_SIZE,
+                                  8>;
+vector<pair<string, SizeCompletionCB>> pendingCompletions;
+
+void
+asyncGetSize(string s, SizeCompletionCB cb)
+{
+    pendingCompletions.emplace_back(std::move(s), cb);
+}
+
+void
+runPendingCompletions()
+{
+    auto completions = std::move(pendingCompletions);
+    pendingCompletions.clear();
+    for (auto& [s, cb] : completions) {
+        cb(s.size());
+    }
+}
+
+// A coroutine that starts eagerly and destroys itself when done
+struct DetachedTask
+{
+    struct promise_type
+    {
+        DetachedTask get_return_object() { return {}; }
+        suspend_never initial_suspend() noexcept { return {}; }
+        suspend_never final_suspend() noexcept { return {}; }
+        void return_void() {}
+        void unhandled_exception() { terminate(); }
+    };
+};
+
+DetachedTask
+sumSizes(size_t& total)
+{
+    total += co_await awaitCallback<SizeCompletionCB>([](SizeCompletionCB cb) { asyncGetSize("hello", cb); });
+    total += co_await awaitCallback<SizeCompletionCB>([](SizeCompletionCB cb) { cb(6); });
+    total += co_await awaitCallback<SizeCompletionCB>([](SizeCompletionCB cb) { asyncGetSize("world!!", cb); });
+}
+
 DynamicCB
 getCB1()
 {
@@ -65,6 +157,33 @@ getLargeCB1()
     } };
 }
 
+// Same as DynamicCB, but spills go through a memory_resource. 32 bytes.
+using PmrDynamicCB = PolicyCB::pmr::Callback<int(string, string),
+                                             MovePolicy::DYNAMIC,
+                                             CopyPolicy::DYNAMIC,
+                                             DestroyPolicy::DYNAMIC,
+                                             SBOPolicy::DYNAMIC_GROWTH,
+                                             16>;
+
+PmrDynamicCB
+getLargePmrCB1(std::pmr::memory_resource* resource)
+{
+    static string largeString(1024, 'a');
+    return PmrDynamicCB{ std::allocator_arg,
+                         std::pmr::polymorphic_allocator<unsigned char>(resource),
+                         [largeString = largeString](string a, string b) {
+                             return a.size() + b.size() + largeString.size();
+                         } };
+}
+
+// VIRTCALL, relocated by memcpy, spills through a memory_resource
+using PmrRelocatingCB = PolicyCB::pmr::Callback<int(string, string),
+                                                MovePolicy::TRIVIAL_RELOCATION,
+                                                CopyPolicy::NOCOPY,
+                                                DestroyPolicy::DYNAMIC,
+                                                SBOPolicy::DYNAMIC_GROWTH,
+                                                16>;
+
 FixedDynamicCB
 getCB2()
 {
@@ -82,6 +201,15 @@ getLargeCB2()
 }
 */
 
+VtableDynamicCB
+getLargeVtableCB1()
+{
+    static string largeString(1024, 'a');
+    return VtableDynamicCB{ [largeString = largeString](string a, string b) {
+        return a.size() + b.size() + largeString.size();
+    } };
+}
+
 TrivialCB
 getCB3()
 {
@@ -111,6 +239,148 @@ getMidCB4()
     double d = 1.5;
     return FixedTrivialCB{ [d = d](string a, string b) { return a.size() + b.size() + d; } };
 }
+
+// Copies of trivially copyable Callbacks carry the callable built in their
+// buffer along: 11 for 0, 12 for 1. Not inlined, so that GCC sees the
+// construction and the copy of the vector in one function, as when it dropped
+// the stores constructing the callables at -O2.
+__attribute__((noinline)) int
+copyFixedCB(size_t which)
+{
+    int offsets[2] = { 1, 2 };
+    auto addFirst = [offset = &offsets[0]](string a, string b) -> int { return a.size() + b.size() + *offset; };
+    auto addSecond = [offset = &offsets[1]](string a, string b) -> int { return a.size() + b.size() + *offset; };
+    vector<FixedTrivialCB> copies{ FixedTrivialCB{ addFirst }, FixedTrivialCB{ addSecond } };
+    FixedTrivialCB copy = copies[which];
+    return copy("hello", "world");
+}
+
+struct ArmState
+{
+    int live = 0;
+    bool armed = false;
+};
+
+// Counts its live copies. Once armed, copying or moving throws.
+template<std::size_t PaddingSize>
+struct ArmedCall
+{
+    ArmState* state;
+    struct NoPadding
+    {};
+    [[no_unique_address]] std::conditional_t<PaddingSize == 0, NoPadding, std::array<char, PaddingSize>> padding{};
+
+    explicit ArmedCall(ArmState* state)
+      : state(state)
+    {
+        ++state->live;
+    }
+    ArmedCall(const ArmedCall& other)
+      : state(other.state)
+    {
+        if (state->armed) {
+            throw std::runtime_error("copy");
+        }
+        ++state->live;
+    }
+    ArmedCall(ArmedCall&& other)
+      : ArmedCall(static_cast<const ArmedCall&>(other))
+    {
+    }
+    ~ArmedCall() { --state->live; }
+    int operator()(string a, string b) { return state->live; }
+};
+
+// Assigns a Callback holding an armed callable to one holding another:
+// the failed assignment leaves it empty, and no callable is destroyed twice
+template<typename CB, std::size_t PaddingSize>
+void
+throwInAssignment(bool move)
+{
+    ArmState state;
+    {
+        CB src{ ArmedCall<PaddingSize>{ &state } };
+        CB dst{ ArmedCall<PaddingSize>{ &state } };
+        state.armed = true;
+        try {
+            if (move) {
+                dst = std::move(src);
+            } else {
+                dst = src;
+            }
+        } catch (const std::runtime_error&) {
+            cout << "threw ";
+        }
+        cout << (dst ? "full " : "empty ") << state.live << " ";
+    }
+    cout << state.live << " ";
+}
+
+// Counts the calls of each callable, keyed by trampoline or vtable
+struct CountingProbe
+{
+    static inline std::map<const void*, int> calls;
+
+    static int enter(const void* key)
+    {
+        return ++calls[key];
+    }
+
+    static void exit(const void*, int) {}
+};
+
+using ProbedDynamicCB = Callback<int(string, string),
+                                 MovePolicy::DYNAMIC,
+                                 CopyPolicy::DYNAMIC,
+                                 DestroyPolicy::DYNAMIC,
+                                 SBOPolicy::DYNAMIC_GROWTH,
+                                 16,
+                                 std::allocator<unsigned char>,
+                                 DispatchPolicy::AUTO,
+                                 CountingProbe>;
+
+struct LatencyProbeTag
+{};
+using TimedDynamicCB = Callback<int(string, string),
+                                MovePolicy::DYNAMIC,
+                                CopyPolicy::DYNAMIC,
+                                DestroyPolicy::DYNAMIC,
+                                SBOPolicy::DYNAMIC_GROWTH,
+                                16,
+                                std::allocator<unsigned char>,
+                                DispatchPolicy::AUTO,
+                                LatencyProbe<LatencyProbeTag, 4>>;
+
+// Opcode handlers built at compile time: no dynamic initializer runs
+using OpcodeCB = Callback<int(int) const,
+                          MovePolicy::TRIVIAL_ONLY,
+                          CopyPolicy::TRIVIAL_ONLY,
+                          DestroyPolicy::TRIVIAL_ONLY,
+                          SBOPolicy::FIXED_SIZE,
+                          8>;
+using OpcodePtrCB = Callback<int(int) const,
+                             MovePolicy::TRIVIAL_ONLY,
+                             CopyPolicy::TRIVIAL_ONLY,
+                             DestroyPolicy::TRIVIAL_ONLY,
+                             SBOPolicy::NO_STORAGE,
+                             0>;
+constinit array<OpcodeCB, 3> opcodeTable{ OpcodeCB{ [](int x) { return x + 1; } },
+                                          OpcodeCB{ [k = 3](int x) { return x * k; } },
+                                          OpcodeCB{ [k = 2.5](int x) { return static_cast<int>(x * k); } } };
+constexpr array<OpcodePtrCB, 2> opcodePtrTable{ OpcodePtrCB{ [](int x) { return x - 1; } },
+                                                OpcodePtrCB{ [](int x) { return -x; } } };
+static_assert(opcodePtrTable[1](5) == -5);
+
+// Visitors are passed down by CallbackRef, which only refers to them
+int
+visitWords(const vector<string>& words, size_t depth, CallbackRef<int(const string&)> visit)
+{
+    if (depth == words.size()) {
+        return 0;
+    }
+    return visit(words[depth]) + visitWords(words, depth + 1, visit);
+}
+
 int
 main()
 {
@@ -123,6 +393,54 @@ main()
     DynamicCB anotherLargeCB1 = getLargeCB1();
     cout << anotherLargeCB1("hello", "world") << endl;
 
+    std::pmr::monotonic_buffer_resource arena;
+    PmrDynamicCB largePmrCB1 = getLargePmrCB1(&arena);
+    cout << largePmrCB1("hello", "world") << endl;
+    static_assert(sizeof(largePmrCB1) == 32);
+    PmrDynamicCB anotherLargePmrCB1{ largePmrCB1 };
+    cout << anotherLargePmrCB1("hello", "world") << endl;
+
+    VtableDynamicCB largeVtableCB1 = getLargeVtableCB1();
+    static_assert(sizeof(largeVtableCB1) == 40);
+    VtableDynamicCB anotherLargeVtableCB1{ largeVtableCB1 };
+    cout << anotherLargeVtableCB1("hello", "world") << endl;
+    // A 16-byte capture fits in the buffer since there's no vptr
+    auto sharedString = std::make_shared<string>("shared");
+    VtableDynamicCB vtableCB1{ [s = sharedString](string a, string b) { return a.size() + b.size() + s->size(); } };
+    VtableDynamicCB anotherVtableCB1{ vtableCB1 };
+    cout << anotherVtableCB1("hello", "world") << endl;
+
+    DynamicCB movedLargeCB1{ std::move(anotherLargeCB1) };
+    cout << movedLargeCB1("hello", "world") << endl;
+    anotherLargeCB1 = std::move(movedLargeCB1);
+    cout << anotherLargeCB1("hello", "world") << endl;
+
+    MoveOnlyCB moveOnlyCB{ [p = std::make_unique<int>(3)](string a, string b) { return a.size() + b.size() + *p; } };
+    static_assert(sizeof(moveOnlyCB) == 40);
+    static_assert(!std::is_copy_constructible_v<MoveOnlyCB>);
+    static_assert(std::is_nothrow_move_constructible_v<MoveOnlyCB> &&
+                  std::is_nothrow_move_constructible_v<RelocatingCB>);
+    std::vector<MoveOnlyCB> moveOnlyCBs;
+    std::vector<RelocatingCB> relocatingCBs;
+    for (int i = 0; i < 10; ++i) {
+        moveOnlyCBs.emplace_back([p = std::make_unique<int>(i)](string a, string b) { return a.size() + *p; });
+        relocatingCBs.emplace_back(assumeTriviallyRelocatable(
+          [p = std::make_unique<string>(1024, 'a')](string a, string b) { return a.size() + p->size(); }));
+    }
+    cout << moveOnlyCB("hello", "world") << " " << moveOnlyCBs[9]("hello", "world") << " "
+         << relocatingCBs[9]("hello", "world") << endl;
+    // The heap buffer can't be adopted across memory resources; the callable
+    // is relocated out of it and the buffer freed
+    PmrRelocatingCB pmrRelocatingCB{ std::allocator_arg,
+                                     std::pmr::new_delete_resource(),
+                                     assumeTriviallyRelocatable(
+                                       [p = std::make_unique<string>(1024, 'a'), extra = 1L](string a, string b) {
+                                           return a.size() + p->size() + extra;
+                                       }) };
+    PmrRelocatingCB arenaRelocatingCB{ std::allocator_arg, &arena, [](string a, string b) { return 0; } };
+    arenaRelocatingCB = std::move(pmrRelocatingCB);
+    cout << arenaRelocatingCB("hello", "world") << " " << bool(pmrRelocatingCB) << endl;
+
     cout << getCB2()("hello", "world") << endl;
     cout << getCB2()("very very long string therer's even more string than you even think", "test test stete") << endl;
     static_assert(sizeof(getCB2()) == 16);
@@ -141,6 +459,7 @@ main()
     cout << getCB4()("hello", "world") << endl;
     static_assert(sizeof(getCB4()) == 16);
     cout << getMidCB4()("hello", "world") << endl;
+    cout << copyFixedCB(0) << " " << copyFixedCB(1) << endl;
 
     cout << FunctionRef([](string a, string b) -> int { return a.size() + b.size(); })("hello", "world") << endl;
 
@@ -157,4 +476,595 @@ main()
     // CStyleGetStringSizeCB cb6{ &string::size }; // Please stop using member function pointers in app interface
     CStyleGetStringSizeCB cb6{ [](const string& s) { return s.size(); } };
     cout << cb6("hello") << endl;
-}
\ No newline at end of file
+
+    // noexcept and const signatures. Calls through noexcept ones have no unwind path
+    using NoexceptGetStringSizeCB = Callback<size_t(const string&) noexcept,
+                                             MovePolicy::TRIVIAL_ONLY,
+                                             CopyPolicy::TRIVIAL_ONLY,
+                                             DestroyPolicy::TRIVIAL_ONLY,
+                                             SBOPolicy::FIXED_SIZE,
+                                             8>;
+    // Compilation error! The callable may throw
+    // NoexceptGetStringSizeCB cb7{ [](const string& s) { return s.size(); } };
+    NoexceptGetStringSizeCB cb7{ [](const string& s) noexcept { return s.size(); } };
+    const string hello = "hello";
+    static_assert(noexcept(cb7(hello)));
+    using ConstDynamicCB = Callback<int(string, string) const noexcept,
+                                    MovePolicy::DYNAMIC,
+                                    CopyPolicy::DYNAMIC,
+                                    DestroyPolicy::DYNAMIC,
+                                    SBOPolicy::DYNAMIC_GROWTH,
+                                    16>;
+    using ConstVtableDynamicCB = Callback<int(string, string) const,
+                                          MovePolicy::DYNAMIC,
+                                          CopyPolicy::DYNAMIC,
+                                          DestroyPolicy::DYNAMIC,
+                                          SBOPolicy::DYNAMIC_GROWTH,
+                                          16,
+                                          std::allocator<unsigned char>,
+                                          DispatchPolicy::STATIC_VTABLE>;
+    using NoexceptFunctionRef = Callback<int(string, string) noexcept,
+                                         MovePolicy::TRIVIAL_ONLY,
+                                         CopyPolicy::TRIVIAL_ONLY,
+                                         DestroyPolicy::TRIVIAL_ONLY,
+                                         SBOPolicy::NO_STORAGE,
+                                         0>;
+    // Compilation error! Only callables invocable as const are accepted
+    // ConstDynamicCB{ [i = 0](string a, string b) mutable noexcept { return ++i; } };
+    const ConstDynamicCB constCB{ [s = make_shared<string>("!!")](string a, string b) noexcept {
+        return int(a.size() + s->size());
+    } };
+    const ConstVtableDynamicCB constVtableCB{ [s = string(100, 'a')](string a, string b) { return int(s.size()); } };
+    ConstDynamicCB constCBCopy = constCB;
+    cout << cb7(hello) << " " << constCB("hello", "world") << " " << constCBCopy("a", "b") << " "
+         << constVtableCB("a", "b") << " "
+         << NoexceptFunctionRef([](string a, string b) noexcept -> int { return a.size(); })("hello", "world") << endl;
+
+    CallbackBatch<CStyleGetStringSizeCB> batch;
+    size_t totalSize = 0;
+    batch.push_back(cb6);
+    batch.emplace_back([&totalSize](const string& s) { return totalSize += s.size(); });
+    batch.push_back(cb6);
+    batch.groupByTarget();
+    batch.invokeAll("hello");
+    cout << batch.size() << " " << totalSize << " " << batch.invoke(2, "world!") << endl;
+
+    CallbackList<int(string, string), 256> cbList;
+    for (int i = 0; i < 100; ++i) {
+        cbList.emplace([](string a, string b) { return a.size() + b.size(); });
+        cbList.emplace([s = string(i, 'a')](string a, string b) { return a.size() + s.size(); });
+    }
+    int listTotal = 0;
+    for (auto entry : cbList) {
+        listTotal += entry("hello", "world");
+    }
+    cbList.invokeAll("hello", "world");
+    cout << cbList.size() << " " << listTotal << endl;
+    cbList.clear();
+    cbList.emplace([](string a, string b) { return a.size() + b.size(); });
+    cout << cbList.size() << " " << (*cbList.begin())("hello", "world") << endl;
+    // An entry capturing 8 bytes takes them plus a one-pointer header: 16
+    // bytes, no more than a FIXED_SIZE FUNC_PTR Callback
+    CallbackList<int(string, string)> capturingList;
+    for (int i = 0; i < 100; ++i) {
+        capturingList.emplace([&listTotal](string a, string b) { return listTotal; });
+    }
+    cout << capturingList.bytesUsed() / capturingList.size() << endl;
+
+    // Each entry gets its own copy of an rvalue reference argument, so the
+    // second one does not see a string the first moved from: 10
+    CallbackList<int(string&&)> movingList;
+    size_t movedTotal = 0;
+    for (int i = 0; i < 2; ++i) {
+        movingList.emplace([&movedTotal](string&& s) {
+            string taken = std::move(s);
+            return movedTotal += taken.size();
+        });
+    }
+    movingList.invokeAll("hello");
+    cout << movedTotal << endl;
+
+    Signal<MoveOnlyCB> signal;
+    atomic<int> emitted{ 0 };
+    auto conn1 = signal.connect([&emitted](string a, string b) { return emitted += a.size(); });
+    auto conn2 = signal.connect([&emitted, p = make_unique<int>(2)](string a, string b) { return emitted += *p; });
+    signal("hello", "world");
+    cout << signal.slotCount() << " " << emitted << " " << signal.disconnect(conn1) << " " << signal.disconnect(conn1)
+         << endl;
+    vector<thread> emitters;
+    for (int i = 0; i < 4; ++i) {
+        emitters.emplace_back([&signal] {
+            for (int j = 0; j < 1000; ++j) {
+                signal.emit("hello", "world");
+            }
+        });
+    }
+    for (int i = 0; i < 100; ++i) {
+        auto conn = signal.connect([](string a, string b) { return 0; });
+        signal.disconnect(conn);
+    }
+    for (auto& t : emitters) {
+        t.join();
+    }
+    cout << signal.slotCount() << " " << emitted << " " << signal.disconnect(conn2) << endl;
+
+    TaskQueue<FixedTrivialCB, 8, OverflowPolicy::SPILL> taskQueue;
+    atomic<int> taskTotal{ 0 };
+    vector<thread> producers;
+    for (int i = 0; i < 4; ++i) {
+        producers.emplace_back([&taskQueue, &taskTotal] {
+            for (int j = 0; j < 1000; ++j) {
+                taskQueue.push([&taskTotal](string a, string b) { return taskTotal += a.size(); });
+            }
+        });
+    }
+    size_t tasksRun = 0;
+    while (tasksRun < 4000) {
+        tasksRun += taskQueue.runAll("hello", "world");
+    }
+    for (auto& t : producers) {
+        t.join();
+    }
+    // Tracks how many copies of it are alive, to check that the queue destroys rejected and consumed tasks
+    struct LiveCounted
+    {
+        int* live;
+        explicit LiveCounted(int* live) noexcept
+          : live(live)
+        {
+            ++*live;
+        }
+        LiveCounted(const LiveCounted& other) noexcept
+          : live(other.live)
+        {
+            ++*live;
+        }
+        ~LiveCounted() { --*live; }
+        int operator()(string a, string b) { return *live; }
+    };
+    TaskQueue<FixedDynamicCB, 2, OverflowPolicy::REJECT> rejectingQueue;
+    int live = 0;
+    int rejected = 0;
+    for (int i = 0; i < 3; ++i) {
+        rejected += !rejectingQueue.push(LiveCounted{ &live });
+    }
+    cout << taskTotal << " " << rejected << " " << live << " " << rejectingQueue.runAll("a", "b") << " " << live
+         << endl;
+
+    // A producer's spilled tasks run after its tasks in the ring, even while
+    // a slot claimed before them by another producer is not published yet:
+    // 0 0abcde
+    struct PublishGate
+    {
+        atomic<bool> claimed{ false };
+        atomic<bool> open{ false };
+    };
+    static string taskOrder;
+    // Holds its slot claimed but unpublished until the gate opens, as the
+    // first move happens when constructing the Callback in the slot
+    struct SlowToPublish
+    {
+        PublishGate* gate;
+        explicit SlowToPublish(PublishGate* gate) noexcept
+          : gate(gate)
+        {
+        }
+        SlowToPublish(const SlowToPublish&) = default;
+        SlowToPublish(SlowToPublish&& other) noexcept
+          : gate(other.gate)
+        {
+            if (!gate->claimed.exchange(true)) {
+                while (!gate->open) {
+                    this_thread::yield();
+                }
+            }
+        }
+        int operator()(string a, string b) { return (taskOrder += '0').size(); }
+    };
+    TaskQueue<FixedDynamicCB, 4, OverflowPolicy::SPILL> spillingQueue;
+    PublishGate gate;
+    thread slowProducer([&spillingQueue, &gate] { spillingQueue.push(SlowToPublish{ &gate }); });
+    while (!gate.claimed) {
+        this_thread::yield();
+    }
+    // a, b and c go to the ring, d and e spill
+    for (char c : string("abcde")) {
+        spillingQueue.push([c](string a, string b) { return (taskOrder += c).size(); });
+    }
+    const bool ranUnpublished = spillingQueue.runOne("a", "b");
+    gate.open = true;
+    slowProducer.join();
+    spillingQueue.runAll("a", "b");
+    cout << ranUnpublished << " " << taskOrder << endl;
+
+    // Timers fire in deadline order, whichever level of the wheel they start
+    // in; cancelled ones never do: 1 0 1 1 ab 1 abc 0
+    TimerWheel<FixedTrivialCB> timers;
+    string fired;
+    timers.scheduleAt(70000, [&fired](string a, string b) { return (fired += "c").size(); });
+    timers.scheduleAt(300, [&fired](string a, string b) { return (fired += "b").size(); });
+    timers.scheduleAfter(5, [&fired](string a, string b) { return (fired += a).size(); });
+    auto cancelledTimer = timers.scheduleAt(100, [&fired](string a, string b) { return (fired += "x").size(); });
+    cout << timers.cancel(cancelledTimer) << " ";
+    cout << timers.cancel(cancelledTimer) << " " << timers.advance(200, "a", "b") << " ";
+    cout << timers.advance(1000, "a", "b") << " " << fired << " ";
+    cout << timers.advance(100000, "a", "b") << " " << fired << " " << timers.size() << endl;
+
+    // Handlers swapped under readers: trivial 16 byte Callbacks as atomic
+    // snapshots, others on the heap: 1 10 5 helloworld!
+    AtomicCallback<FixedTrivialCB> atomicHandler{ [](string a, string b) { return int(a.size() + b.size()); } };
+    static_assert(decltype(atomicHandler)::snapshot);
+    AtomicCallback<DynamicCB> atomicHeapHandler{ [](string a, string b) { return 0; } };
+    static_assert(!decltype(atomicHeapHandler)::snapshot);
+    string handled;
+    atomicHeapHandler.store([&handled, suffix = string("!")](string a, string b) {
+        handled = a + b + suffix;
+        return 1;
+    });
+    cout << atomicHeapHandler("hello", "world") << " " << atomicHandler("hello", "world") << " ";
+    atomicHandler.store([](string a, string b) { return int(a.size()); });
+    cout << atomicHandler.load()("hello", "world") << " " << handled << endl;
+
+    // Stages called inline from one Callback, erased Callbacks among them
+    // too; captureless ones fold into a function pointer: 10 21 20
+    auto concat = [](string a, string b) { return a + b; };
+    auto length = [](const string& str) { return int(str.size()); };
+    DynamicCB composedCB{ compose(concat, length) };
+    FixedTrivialCB sizeSumStage{ [](string a, string b) { return int(a.size() + b.size()); } };
+    DynamicCB composedErasedCB{ compose(sizeSumStage, [](int n) { return 2 * n + 1; }) };
+    auto composedPtrCB = makeCallback<int(string, string)>(compose(concat, length, [](int n) { return 2 * n; }));
+    static_assert(decltype(composedPtrCB)::dispatchMethod == DynamicDispatchMethod::NO_DISPATCH);
+    cout << composedCB("hello", "world") << " " << composedErasedCB("hello", "world") << " "
+         << composedPtrCB("hello", "world") << endl;
+
+    // Empty Callbacks, default constructed, from nullptr or reset, for every
+    // dispatch method: 0 0 0 0 1 0 1
+    vector<DynamicCB> emptyDynamicCBs(4);
+    emptyDynamicCBs.resize(64);
+    FixedTrivialCB emptyTrivialCB = nullptr;
+    constexpr Callback<int(int) const,
+                       MovePolicy::TRIVIAL_ONLY,
+                       CopyPolicy::TRIVIAL_ONLY,
+                       DestroyPolicy::TRIVIAL_ONLY,
+                       SBOPolicy::NO_STORAGE,
+                       0>
+      emptyPtrCB;
+    static_assert(!emptyPtrCB && emptyPtrCB == nullptr);
+    MoveOnlyCallback<int(string, string)> resetCB{ [](string a, string b) { return 0; } };
+    const bool heldBeforeReset = static_cast<bool>(resetCB);
+    resetCB.reset();
+    DynamicCB convertedEmptyCB{ FixedTrivialCB{} };
+    cout << static_cast<bool>(emptyDynamicCBs.back()) << " " << static_cast<bool>(emptyTrivialCB) << " "
+         << (resetCB != nullptr) << " " << static_cast<bool>(convertedEmptyCB) << " " << heldBeforeReset << " ";
+    emptyDynamicCBs.back() = DynamicCB{ [](string a, string b) { return 1; } };
+    cout << static_cast<bool>(emptyDynamicCBs.front()) << " " << emptyDynamicCBs.back()("a", "b") << endl;
+
+    size_t coroTotal = 0;
+    sumSizes(coroTotal);
+    cout << coroTotal << " ";
+    runPendingCompletions();
+    cout << coroTotal << " ";
+    runPendingCompletions();
+    cout << coroTotal << " " << sizeof(SizeCompletionCB) << endl;
+
+    auto sizeSum = [](string a, string b) -> int { return a.size() + b.size(); };
+    auto withSuffix = [suffix = string(100, '!')](string a, string b) -> int { return a.size() + suffix.size(); };
+    using ClosedCB = ClosedCallback<int(string, string),
+                                    MovePolicy::DYNAMIC,
+                                    CopyPolicy::DYNAMIC,
+                                    DestroyPolicy::DYNAMIC,
+                                    decltype(sizeSum),
+                                    decltype(withSuffix)>;
+    ClosedCB closedCB{ sizeSum };
+    cout << closedCB("hello", "world") << " ";
+    closedCB = withSuffix;
+    ClosedCB closedCBCopy = closedCB;
+    vector<ClosedCB> closedCBs(10, closedCBCopy);
+    closedCBs.emplace_back(sizeSum);
+    cout << closedCBCopy("hello", "world") << " " << closedCBs.back()("a", "b") << " " << closedCBs.front()("a", "b")
+         << " " << closedCBs.front().typeIndex() << endl;
+    // Compilation error! Not one of the listed types
+    // closedCB = [](string a, string b) { return 0; };
+
+    // A callable whose move throws during assignment leaves the
+    // ClosedCallback vacant, so the previous one is destroyed only once.
+    // Copying a vacant one copies nothing: threw 255 255 2 0
+    struct CountedCall
+    {
+        int* live;
+        explicit CountedCall(int* live) noexcept
+          : live(live)
+        {
+            ++*live;
+        }
+        CountedCall(const CountedCall& other) noexcept
+          : live(other.live)
+        {
+            ++*live;
+        }
+        ~CountedCall() { --*live; }
+        int operator()(string a, string b) { return *live; }
+    };
+    struct ThrowingMove
+    {
+        ThrowingMove() = default;
+        ThrowingMove(const ThrowingMove&) = default;
+        ThrowingMove(ThrowingMove&&) { throw std::runtime_error("move"); }
+        int operator()(string a, string b) { return 0; }
+    };
+    int closedLive = 0;
+    {
+        using GuardedClosedCB = ClosedCallback<int(string, string),
+                                               MovePolicy::DYNAMIC,
+                                               CopyPolicy::DYNAMIC,
+                                               DestroyPolicy::DYNAMIC,
+                                               CountedCall,
+                                               ThrowingMove>;
+        GuardedClosedCB guardedCB{ CountedCall{ &closedLive } };
+        const ThrowingMove throwingMove;
+        try {
+            guardedCB = throwingMove;
+        } catch (const std::runtime_error&) {
+            cout << "threw ";
+        }
+        GuardedClosedCB guardedCopy = guardedCB;
+        cout << guardedCB.typeIndex() << " " << guardedCopy.typeIndex() << " ";
+
+        auto relocatableCounted = assumeTriviallyRelocatable(CountedCall{ &closedLive });
+        using RelocatingClosedCB = ClosedCallback<int(string, string),
+                                                  MovePolicy::TRIVIAL_RELOCATION,
+                                                  CopyPolicy::DYNAMIC,
+                                                  DestroyPolicy::DYNAMIC,
+                                                  decltype(sizeSum),
+                                                  decltype(relocatableCounted)>;
+        RelocatingClosedCB relocatingCB{ relocatableCounted };
+        RelocatingClosedCB relocatedCB{ std::move(relocatingCB) };
+        RelocatingClosedCB vacantCopy{ relocatingCB };
+        // relocatableCounted and the one in relocatedCB
+        cout << closedLive << " ";
+    }
+    cout << closedLive << endl;
+
+    // Copy and move assignments that throw once the previous callable is
+    // destroyed leave the Callback empty, and nothing is destroyed twice:
+    // threw empty 1 0, for inline and heap-held callables of each dispatch
+    // method
+    throwInAssignment<DynamicCB, 0>(false);
+    throwInAssignment<DynamicCB, 0>(true);
+    throwInAssignment<DynamicCB, 32>(false);
+    throwInAssignment<VtableDynamicCB, 0>(false);
+    throwInAssignment<VtableDynamicCB, 0>(true);
+    throwInAssignment<VtableDynamicCB, 32>(false);
+    cout << endl;
+
+    // MoveOnlyCB keeps the armed callable, whose move may throw, on the heap
+    // although it fits inline: moves only take its pointer, 1 1
+    {
+        ArmState state;
+        MoveOnlyCB armedCB{ ArmedCall<0>{ &state } };
+        state.armed = true;
+        MoveOnlyCB movedCB{ std::move(armedCB) };
+        MoveOnlyCB assignedCB;
+        assignedCB = std::move(movedCB);
+        cout << state.live << " " << assignedCB("hello", "world") << endl;
+    }
+
+    using ClosedTrivialCB = ClosedCallback<int(string, string),
+                                           MovePolicy::TRIVIAL_ONLY,
+                                           CopyPolicy::TRIVIAL_ONLY,
+                                           DestroyPolicy::TRIVIAL_ONLY,
+                                           decltype(sizeSum),
+                                           int (*)(string, string)>;
+    static_assert(std::is_trivially_copyable_v<ClosedTrivialCB> && sizeof(ClosedTrivialCB) == 16);
+    ClosedTrivialCB closedTrivialCB{ sizeSum };
+    ClosedTrivialCB closedTrivialCB2 = closedTrivialCB;
+    closedTrivialCB2 = +[](string a, string b) { return int(a.size()); };
+    cout << closedTrivialCB("hello", "world") << " " << closedTrivialCB2("hello", "world") << endl;
+
+    // Counts deep copies of a large, effectively immutable capture
+    struct ConfigBlob
+    {
+        int* copies;
+        string config = string(1024, 'c');
+        ConfigBlob(int* copies)
+          : copies(copies)
+        {
+        }
+        ConfigBlob(const ConfigBlob& other)
+          : copies(other.copies)
+          , config(other.config)
+        {
+            ++*copies;
+        }
+        int operator()(string a, string b) const { return config.size() + a.size(); }
+    };
+    using SharedCB = Callback<int(string, string),
+                              MovePolicy::DYNAMIC,
+                              CopyPolicy::DYNAMIC,
+                              DestroyPolicy::DYNAMIC,
+                              SBOPolicy::SHARED_GROWTH,
+                              16>;
+    using ConstSharedCB = Callback<int(string, string) const,
+                                   MovePolicy::DYNAMIC,
+                                   CopyPolicy::DYNAMIC,
+                                   DestroyPolicy::DYNAMIC,
+                                   SBOPolicy::SHARED_GROWTH,
+                                   16,
+                                   std::allocator<unsigned char>,
+                                   DispatchPolicy::STATIC_VTABLE>;
+    int blobCopies = 0;
+    {
+        SharedCB sharedCB{ ConfigBlob{ &blobCopies } };
+        vector<SharedCB> subscribers(10, sharedCB);
+        subscribers[3] = sharedCB;
+        subscribers[4] = SharedCB{ [](string a, string b) { return int(a.size() + b.size()); } };
+        int copiesBeforeInvoke = blobCopies;
+        int sharedTotal = subscribers[0]("a", "b") + sharedCB("a", "b");
+        cout << copiesBeforeInvoke << " " << blobCopies << " " << sharedTotal << " " << subscribers[4]("a", "b")
+             << endl;
+    }
+    blobCopies = 0;
+    {
+        ConstSharedCB sharedCB{ ConfigBlob{ &blobCopies } };
+        vector<ConstSharedCB> subscribers(10, sharedCB);
+        subscribers.emplace_back(std::move(sharedCB));
+        int sharedTotal = 0;
+        for (auto& cb : subscribers) {
+            sharedTotal += cb("a", "b");
+        }
+        cout << blobCopies << " " << sharedTotal << endl;
+    }
+
+    auto captureless = makeCallback<int(string, string)>([](string a, string b) -> int { return a.size(); });
+    int base = 3;
+    auto returnBase = [&base](string a, string b) -> int { return base; };
+    auto capturingRef = makeCallback<int(string, string)>(returnBase);
+    auto capturingString =
+      makeCallback<int(string, string)>([s = string(30, 's')](string a, string b) -> int { return s.size(); });
+    auto capturingUniquePtr = makeCallback<int(string, string)>(
+      [p = make_unique<int>(4)](string a, string b) -> int { return *p; });
+    static_assert(sizeof(captureless) == 8 && sizeof(capturingRef) == 16);
+    static_assert(!std::is_copy_constructible_v<decltype(capturingUniquePtr)>);
+    using CountStrings = int (*)(string, string);
+    static_assert(CallbackFor<int(string, string), CountStrings>::dispatchMethod == DynamicDispatchMethod::NO_DISPATCH);
+    cout << captureless("hello", "world") << " " << capturingRef("hello", "world") << " "
+         << capturingString("hello", "world") << " " << capturingUniquePtr("hello", "world") << endl;
+    cout << CallbackFor<int(string, string), CountStrings>::report.view() << endl;
+    cout << CallbackFor<int(string, string), decltype(returnBase)>::report.view() << endl;
+    cout << CallbackFor<int(string, string), std::function<int(string, string)>>::report.view() << endl;
+
+    // Converting between Callbacks keeps a single layer of dispatch: trivial
+    // callables keep their trampoline, function pointers are unwrapped
+    FixedTrivialCB fixedCB = getMidCB4();
+    TrivialCB fromFixedCB{ fixedCB };
+    VtableDynamicCB vtableFromFixedCB{ fixedCB };
+    MoveOnlyCB moveOnlyFromVtableCB{ VtableDynamicCB{ vtableFromFixedCB } };
+    DynamicCB fromFunctionRef{ FunctionRef([](string a, string b) -> int { return b.size(); }) };
+    DynamicCB fromFixedDynamicCB{ FixedDynamicCB{ [n = 3](string a, string b) -> int { return n; } } };
+    cout << fromFixedCB("hello", "world") << " " << vtableFromFixedCB("hello", "world") << " "
+         << moveOnlyFromVtableCB("hello", "world") << " " << fromFunctionRef("hello", "world") << " "
+         << fromFixedDynamicCB("hello", "world") << endl;
+    // Compilation error! A DYNAMIC_GROWTH callable may not fit a FIXED_SIZE buffer
+    // FixedDynamicCB fromDynamicCB{ DynamicCB{ [](string a, string b) -> int { return 0; } } };
+    // VIRTCALL Callbacks keep the bytes of FUNC_PTR ones next to their
+    // trampoline, which calls jump to directly: 11 1 2 3 3
+    DynamicCB dynamicFromFixedCB{ fixedCB };
+    DynamicCB countingFromFixedCB{ FixedTrivialCB{ [n = 0](string a, string b) mutable { return ++n; } } };
+    cout << dynamicFromFixedCB("hello", "world") << " " << countingFromFixedCB("a", "b") << " "
+         << countingFromFixedCB("a", "b") << " ";
+    DynamicCB countingCopy{ countingFromFixedCB };
+    DynamicCB countingMoved{ std::move(countingFromFixedCB) };
+    cout << countingCopy("a", "b") << " " << countingMoved("a", "b") << endl;
+
+    // CallbackRef binds stateful callables without owning them
+    int visited = 0;
+    auto countingVisitor = [&visited](const string& word) -> int {
+        ++visited;
+        return word.size();
+    };
+    static_assert(sizeof(CallbackRef<int(const string&)>) == 16);
+    static_assert(is_trivially_copyable_v<CallbackRef<int(const string&)>> && is_trivially_copyable_v<FixedTrivialCB>);
+    cout << visitWords({ "hello", "world", "!" }, 0, countingVisitor) << " " << visited << " "
+         << visitWords({ "a", "b" }, 0, [&visited](const string& word) -> int { return visited; }) << endl;
+    // Compilation error! DYNAMIC policies are meaningless for a reference
+    // using DynamicRef = Callback<int(const string&),
+    //                               MovePolicy::DYNAMIC,
+    //                               CopyPolicy::DYNAMIC,
+    //                               DestroyPolicy::DYNAMIC,
+    //                               SBOPolicy::REFERENCE>;
+    // DynamicRef dynamicRef{ countingVisitor };
+
+    // Binding a member function only stores the object pointer
+    struct Greeter
+    {
+        string greeting;
+        int greet(string a, string b) const
+        {
+            return greeting.size() + a.size();
+        }
+    };
+    Greeter greeter{ "hi" };
+    FixedTrivialCB boundGreet{ bindMember<&Greeter::greet>(greeter) };
+    static_assert(sizeof(boundGreet) == 16);
+    cout << boundGreet("hello", "world") << endl;
+
+    // Both probed Callbacks hold the same lambda type, so they share a key:
+    // 2 calls for 1 key
+    auto addSizes = [](string a, string b) -> int { return a.size() + b.size(); };
+    ProbedDynamicCB probed1{ addSizes }, probed2{ addSizes };
+    probed1("hello", "world");
+    probed2("hello", "world");
+    static_assert(sizeof(ProbedDynamicCB) == sizeof(DynamicCB));
+    cout << CountingProbe::calls.begin()->second << " calls for " << CountingProbe::calls.size() << " key" << endl;
+
+    // Each thread counts into a table of its own; the report merges those of
+    // exited threads too: 4000 calls, 1000 sampled, for 1 key
+    vector<thread> timedCallers;
+    for (int i = 0; i < 4; ++i) {
+        timedCallers.emplace_back([&addSizes] {
+            TimedDynamicCB timed{ addSizes };
+            for (int j = 0; j < 1000; ++j) {
+                timed("hello", "world");
+            }
+        });
+    }
+    for (auto& t : timedCallers) {
+        t.join();
+    }
+    auto timedStats = LatencyProbe<LatencyProbeTag, 4>::snapshot();
+    cout << timedStats[0].calls << " calls, " << timedStats[0].sampledCalls << " sampled, for " << timedStats.size()
+         << " key" << endl;
+
+    // By-value arguments are moved once, into the callable, whatever the
+    // dispatch method; small trivially copyable ones are passed in registers
+    struct MoveCounted
+    {
+        int* moves;
+        explicit MoveCounted(int* moves)
+          : moves(moves)
+        {
+        }
+        MoveCounted(MoveCounted&& other) noexcept
+          : moves(other.moves)
+        {
+            ++*moves;
+        }
+    };
+    int moves = 0;
+    auto takeByValue = [](MoveCounted counted, int x) -> int { return x; };
+    using MoveCountedFT = int(MoveCounted, int);
+    Callback<MoveCountedFT, MovePolicy::DYNAMIC, CopyPolicy::DYNAMIC, DestroyPolicy::DYNAMIC, SBOPolicy::DYNAMIC_GROWTH>
+      virtcallCB{ takeByValue };
+    Callback<MoveCountedFT,
+             MovePolicy::TRIVIAL_ONLY,
+             CopyPolicy::TRIVIAL_ONLY,
+             DestroyPolicy::TRIVIAL_ONLY,
+             SBOPolicy::FIXED_SIZE,
+             8>
+      funcPtrCB{ takeByValue };
+    virtcallCB(MoveCounted(&moves), 1);
+    funcPtrCB(MoveCounted(&moves), 2);
+    cout << moves << endl;
+
+    // 11 30 25 9
+    cout << opcodeTable[0](10) << " " << opcodeTable[1](10) << " " << opcodeTable[2](10) << " " << opcodePtrTable[0](10)
+         << endl;
+
+#ifdef POLICYCB_SBO_PROFILE
+    using ProfiledCB =
+      Callback<int(), MovePolicy::DYNAMIC, CopyPolicy::DYNAMIC, DestroyPolicy::DYNAMIC, SBOPolicy::DYNAMIC_GROWTH, 24>;
+    ProfiledCB smallCapture{ [x = 1] { return x; } };
+    ProfiledCB bigCapture{ [x = std::array<long, 8>{}] { return static_cast<int>(x[0]); } };
+    ProfiledCB bigCopy(bigCapture);
+    ProfiledCB moved(std::move(smallCapture));
+    for (const SBOProfileEntry& entry : sboProfileSnapshot()) {
+        if (entry.name == internal::typeName<ProfiledCB>()) {
+            // 2 constructions, 1 spills, 1 copies (1 allocating), 1 moves, 72 bytes for all
+            cout << entry.constructions << " constructions, " << entry.heapSpills << " spills, " << entry.copies
+                 << " copies (" << entry.cloneAllocations << " allocating), " << entry.moves << " moves, "
+                 << entry.bufferSizeFor(1) << " bytes for all" << endl;
+        }
+    }
+    dumpSBOProfile(stdout);
+#endif
+}